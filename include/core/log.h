@@ -1,3 +1,5 @@
 #pragma once
 
 void log_error(const char* message, ...);
+
+void log_info(const char* message, ...);
@@ -1,4 +1,5 @@
 #pragma once
+#include <stdint.h>
 
 #include "core/vector.h"
 #include "game/ui_element.h"
@@ -11,6 +12,7 @@ typedef enum UIElementAnimationEndBehaviour {
     ANIMATION_LOOP,
 } UIElementAnimationEndBehaviour;
 
+// Describes an animation to start, see animation_system_push
 typedef struct UIElementAnimation {
     UIElement from;
     UIElement to;
@@ -20,19 +22,135 @@ typedef struct UIElementAnimation {
     UIElementAnimationEndBehaviour behaviour;
 } UIElementAnimation;
 
+// Every float of a UIElement that is interpolated
+typedef enum AnimationChannel {
+    ANIMATION_CHANNEL_X,
+    ANIMATION_CHANNEL_Y,
+    ANIMATION_CHANNEL_Z,
+    ANIMATION_CHANNEL_ROTATION,
+    ANIMATION_CHANNEL_R,
+    ANIMATION_CHANNEL_G,
+    ANIMATION_CHANNEL_B,
+    ANIMATION_CHANNEL_A,
+    ANIMATION_CHANNEL_WIDTH,
+    ANIMATION_CHANNEL_HEIGHT,
+    ANIMATION_CHANNEL_HITBOX_X,
+    ANIMATION_CHANNEL_HITBOX_Y,
+    ANIMATION_CHANNEL_HITBOX_WIDTH,
+    ANIMATION_CHANNEL_HITBOX_HEIGHT,
+    ANIMATION_CHANNEL_COUNT,
+} AnimationChannel;
+
+// Card an animation ends on, used to hide the animated slots in the board
+typedef struct AnimationTarget {
+    UIType type;
+    SelectionLocation location;
+    int card_index;
+} AnimationTarget;
+
+/** Refers to a running animation.
+ * The generation is bumped every time a slot is reused, so handles of finished animations
+ * are detected instead of silently pointing at a newer one.
+ */
+typedef struct AnimationHandle {
+    uint32_t slot;
+    uint32_t generation;
+} AnimationHandle;
+
+typedef struct AnimationSlot {
+    // position in the dense arrays while the slot is in use
+    uint32_t dense_index;
+    uint32_t generation;
+    // next slot of the free list while unused
+    uint32_t next_free;
+} AnimationSlot;
+
+#define ANIMATION_LOCATION_COUNT 16
+
+/** Animations stored as a structure of arrays.
+ * Every channel is a separate float array so the interpolation kernel can process several
+ * animations per instruction. All arrays are parallel and hold ui_animation_count entries.
+ * Finished animations are swap-removed, handles stay valid through the slot indirection.
+ */
 typedef struct AnimationSystem {
-    Vector ui_animations;
+    size_t ui_animation_count;
+
+    Vector from[ANIMATION_CHANNEL_COUNT];
+    Vector to[ANIMATION_CHANNEL_COUNT];
+    // values of the last animation_system_interpolate
+    Vector current[ANIMATION_CHANNEL_COUNT];
+
+    Vector elapsed;
+    Vector duration;
+    // UIElementAnimationEndBehaviour
+    Vector behaviour;
+
+    // the from element, providing everything that isn't interpolated
+    Vector templates;
+    Vector targets;
+    // uint32_t slot of each dense entry
+    Vector dense_slots;
+
+    // AnimationSlot pool, freed slots are reused through the free list
+    Vector slots;
+    uint32_t free_slot;
+
+    AnimationHandle last_pushed;
+
+    // bit k of animated[location] is set if the card at (location, k) is the source or
+    // destination of an animation, rebuilt once per frame
+    uint32_t animated[ANIMATION_LOCATION_COUNT];
 } AnimationSystem;
 
 AnimationSystem animation_system_init(void);
 
 void animation_system_free(AnimationSystem* system);
 
-UIElement animation_system_get_next_frame(
+AnimationHandle animation_system_push(
     AnimationSystem* system,
-    UIElementAnimation* animation
+    const UIElementAnimation* animation
 );
 
+void animation_system_clear(AnimationSystem* system);
+
+size_t animation_system_count(const AnimationSystem* system);
+
+bool animation_system_is_alive(AnimationSystem* system, AnimationHandle handle);
+
+// elapsed / duration of an animation, negative while it is delayed and 1 once it is gone
+float animation_system_progress(AnimationSystem* system, AnimationHandle handle);
+
+// Stops an animation, does nothing if it already finished
+void animation_system_cancel(AnimationSystem* system, AnimationHandle handle);
+
+/** Continues an animation from where it currently is towards a new element.
+ * The elapsed time restarts from zero.
+ *
+ * @return false if the animation already finished.
+ */
+bool animation_system_retarget(
+    AnimationSystem* system,
+    AnimationHandle handle,
+    const UIElement* to,
+    float duration
+);
+
+// Evaluates the eased value of every channel of every animation
+void animation_system_interpolate(AnimationSystem* system);
+
+/** Builds the element of an animation from the last interpolation.
+ *
+ * @return false if the animation hasn't started yet.
+ */
+bool animation_system_get_frame(AnimationSystem* system, size_t index, UIElement* frame);
+
 void animation_system_update(AnimationSystem* system, Controller* controller, float delta_time);
 
+// Seconds until an animation needs a new frame, 0 while one is running and INFINITY if none
+float animation_system_time_to_next_frame(const AnimationSystem* system);
+
+// Rebuilds the animated bitset from the current animations
+void animation_system_mark_animated(AnimationSystem* anim_sys);
+
+// Tests the animated bitset, valid after animation_system_mark_animated
 bool animation_system_is_animated(AnimationSystem* anim_sys, UIElement* element);
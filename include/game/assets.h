@@ -3,9 +3,18 @@
 #include "rendering/shader.h"
 #include "rendering/texture.h"
 
+// Uniforms of main_shader, in the order they are resolved by shader_init
+typedef enum MainShaderUniform {
+    MAIN_SHADER_SPRITESHEET,
+    MAIN_SHADER_GLYPH_ATLAS,
+    MAIN_SHADER_UNIFORM_COUNT,
+} MainShaderUniform;
+
 typedef struct Assets {
     Shader main_shader;
     Texture spritesheet_texture;
+    // signed distance field of the glyphs, bound to texture unit 1
+    Texture glyph_atlas_texture;
 } Assets;
 
 Assets assets_init();
@@ -0,0 +1,74 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <miniaudio.h>
+
+#include "game/audio_queue.h"
+
+typedef enum SoundId {
+    SOUND_CARD_MOVE,
+    SOUND_COUNT,
+} SoundId;
+
+// Plays of one sound that can overlap, the oldest one is cut off beyond that
+#define AUDIO_VOICES_PER_SOUND 6
+
+// A sound instance reading the shared PCM of its sound with its own cursor
+typedef struct AudioVoice {
+    ma_audio_buffer buffer;
+    ma_sound sound;
+    // play_count when the voice was last started, the lowest one is stolen first
+    // voices are only touched by the mixer callback once the device runs
+    uint64_t started;
+} AudioVoice;
+
+// A sound decoded to PCM in the engine's format, with the voices that play it
+typedef struct SoundBankEntry {
+    float* frames;
+    uint64_t frame_count;
+    AudioVoice voices[AUDIO_VOICES_PER_SOUND];
+} SoundBankEntry;
+
+/** Audio device, engine and sound bank of the game.
+ * Nothing is initialized by audio_init, the engine is started by audio_start once the first
+ * frame is on screen, so opening the audio device doesn't delay the window.
+ * Every sound is decoded once when the engine starts, playing one only restarts a voice.
+ *
+ * The game thread never calls into miniaudio after startup. It pushes commands into the
+ * queue, and the device callback applies them right before mixing the next period.
+ */
+typedef struct Audio {
+    bool started;
+    // the device could not be opened, the game continues without sound
+    bool failed;
+
+    ma_device device;
+    ma_engine engine;
+    SoundBankEntry sounds[SOUND_COUNT];
+    uint64_t play_count;
+
+    AudioQueue queue;
+} Audio;
+
+void audio_init(Audio* audio);
+
+void audio_free(Audio* audio);
+
+/** Opens the device, initializes the engine and decodes the sound bank.
+ * Does nothing if it was already done. The device callback keeps a pointer to audio, so it
+ * must not move afterwards.
+ *
+ * @return false if audio is unavailable.
+ */
+bool audio_start(Audio* audio);
+
+/** Queues a sound to play on a free voice of it, starting the engine first if needed.
+ *
+ * @param pan -1 left to 1 right
+ * @param pitch playback speed, 1 plays the sound as recorded
+ */
+void audio_play(Audio* audio, SoundId sound, float pan, float pitch);
+
+// Queues stopping every voice of a sound
+void audio_stop(Audio* audio, SoundId sound);
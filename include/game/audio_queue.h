@@ -0,0 +1,52 @@
+#pragma once
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef enum AudioCommandType {
+    // starts the sound on a free voice
+    AUDIO_COMMAND_PLAY,
+    // stops every voice of the sound
+    AUDIO_COMMAND_STOP,
+} AudioCommandType;
+
+typedef struct AudioCommand {
+    AudioCommandType type;
+    // SoundId
+    uint32_t sound;
+    // -1 left to 1 right
+    float pan;
+    // playback speed, 1 plays the sound as recorded
+    float pitch;
+    // time_micros when the game thread queued the command, places the sound inside the period
+    uint64_t queued_micros;
+} AudioCommand;
+
+// Must be a power of two, the indices wrap with a mask
+#define AUDIO_QUEUE_CAPACITY 64
+
+/** Lock-free single producer, single consumer ring of audio commands.
+ * The game thread pushes, the mixer callback pops. Indices only ever grow, each side only
+ * writes its own, so the ring never blocks either thread.
+ */
+typedef struct AudioQueue {
+    AudioCommand commands[AUDIO_QUEUE_CAPACITY];
+    _Atomic uint32_t write_index;
+    _Atomic uint32_t read_index;
+    // commands dropped because the mixer fell behind, only touched by the producer
+    uint32_t dropped;
+} AudioQueue;
+
+void audio_queue_init(AudioQueue* queue);
+
+/** Called by the producer only.
+ *
+ * @return false if the ring is full, the command is dropped.
+ */
+bool audio_queue_push(AudioQueue* queue, const AudioCommand* command);
+
+/** Called by the consumer only.
+ *
+ * @return false if the ring is empty.
+ */
+bool audio_queue_pop(AudioQueue* queue, AudioCommand* command);
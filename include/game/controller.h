@@ -24,10 +24,21 @@ typedef struct Controller {
     vec2s mouse_screen;
     UIDragState drag_state;
     bool screen_needs_update;
+
+    // the win and autocomplete sequences are scheduled on the timeline once
+    bool game_over_scheduled;
+    bool autocomplete_scheduled;
+    // the foundations as the win sequence empties them, the game itself stays won
+    Card game_over_foundation[4];
 } Controller;
 
 void controller_update(World* world, double dt);
 
+/** Advances the clock, animations and timeline by dt, and starts the win or autocomplete
+ * sequence once the position calls for it. Neither reads input nor draws.
+ */
+void controller_step(World* world, double dt);
+
 bool controller_handle_card_drop(
     UIElement* dest, SelectionLocation location, uint8_t card_index, World* world);
 
@@ -51,6 +62,13 @@ void controller_toggle_fullscreen(World* world);
 
 void controller_toggle_help(World* world);
 
+void controller_toggle_profiler(World* world);
+
+void controller_dump_trace(World* world);
+
+// Fills every cascade with cards, a fixed worst case layout for debugging and benchmarks
+void controller_fill_cascades(World* world);
+
 void controller_on_framebuffer_resize(World* world, int width, int height);
 
 void controller_on_cursor_position(World* world, double x, double y);
@@ -0,0 +1,37 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct World World;
+
+// Why the main loop woke up to draw a frame
+typedef enum FrameWakeReason {
+    // input or window event
+    FRAME_WAKE_EVENT,
+    FRAME_WAKE_ANIMATION,
+    FRAME_WAKE_TIMELINE,
+    // the clock in the game info ticked over to the next second
+    FRAME_WAKE_CLOCK,
+    FRAME_WAKE_REASON_COUNT,
+} FrameWakeReason;
+
+/** Blocks the main loop until a frame is actually needed.
+ * A frame is drawn on events, while animations run, for timeline callbacks and for the
+ * clock tick. Otherwise the loop sleeps without a timeout, and a minimized window only
+ * wakes up to drain its events.
+ */
+typedef struct FrameScheduler {
+    uint64_t wake_counts[FRAME_WAKE_REASON_COUNT];
+    // wakeups that didn't draw anything because the window is minimized
+    uint64_t minimized_wakes;
+} FrameScheduler;
+
+void frame_scheduler_init(FrameScheduler* scheduler);
+
+/** Waits for the next frame.
+ *
+ * @return false if the window is minimized and no frame should be drawn.
+ */
+bool frame_scheduler_wait(FrameScheduler* scheduler, World* world);
+
+const char* frame_scheduler_reason_name(FrameWakeReason reason);
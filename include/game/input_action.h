@@ -16,6 +16,8 @@ typedef enum InputActionType {
     INPUT_ACTION_SMART_MOVE,
     INPUT_ACTION_POINTER_MOVE,
     INPUT_ACTION_FRAMEBUFFER_RESIZE,
+    INPUT_ACTION_TOGGLE_PROFILER,
+    INPUT_ACTION_DUMP_TRACE,
 
     INPUT_ACTION_AUTOCOMPLETEABLE_GAME,
     INPUT_ACTION_FILL_CASCADES,
@@ -0,0 +1,124 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "rendering/renderer.h"
+
+typedef struct World World;
+typedef struct Mesh Mesh;
+
+typedef enum ProfilerPhase {
+    PROFILER_PHASE_INPUT,
+    PROFILER_PHASE_LAYOUT,
+    PROFILER_PHASE_UI_STATE,
+    PROFILER_PHASE_MESH_BUILD,
+    // uploading the patched board mesh
+    PROFILER_PHASE_UPLOAD,
+    // redrawing the cached board, blitting it and flushing the render queue with its stream
+    PROFILER_PHASE_DRAW,
+    PROFILER_PHASE_SWAP,
+    PROFILER_PHASE_COUNT,
+} ProfilerPhase;
+
+// Startup work timed once, up to the first frame and the deferred audio start after it
+typedef enum ProfilerStartupPhase {
+    PROFILER_STARTUP_WINDOW,
+    PROFILER_STARTUP_ASSETS,
+    PROFILER_STARTUP_WORLD,
+    PROFILER_STARTUP_FIRST_FRAME,
+    PROFILER_STARTUP_AUDIO,
+    // decoding the sound bank, part of PROFILER_STARTUP_AUDIO
+    PROFILER_STARTUP_SOUND_BANK,
+    PROFILER_STARTUP_PHASE_COUNT,
+} ProfilerStartupPhase;
+
+// Frames kept for the rolling percentiles
+#define PROFILER_SAMPLE_COUNT 128
+// Timer queries in flight, results are read back a couple of frames later
+#define PROFILER_GPU_QUERY_COUNT 3
+// Phase events kept for the trace dump
+#define PROFILER_TRACE_EVENT_COUNT 4096
+
+typedef struct ProfilerTraceEvent {
+    uint32_t phase;
+    uint64_t start_micros;
+    uint64_t duration_micros;
+} ProfilerTraceEvent;
+
+typedef struct ProfilerStartup {
+    // time of the first profiler_startup_begin, startup is measured from there
+    uint64_t origin_micros;
+    uint64_t phase_start[PROFILER_STARTUP_PHASE_COUNT];
+    uint64_t phase_micros[PROFILER_STARTUP_PHASE_COUNT];
+    // time until the game responds, from the origin to the first frame being up and the
+    // audio device open, which is the last thing startup waits for
+    uint64_t interactive_micros;
+} ProfilerStartup;
+
+// Startup begins before the world and its profiler exist, so it is timed globally
+extern ProfilerStartup profiler_startup;
+
+typedef struct Profiler {
+    bool show_overlay;
+    bool in_frame;
+
+    uint64_t phase_start[PROFILER_PHASE_COUNT];
+    // time spent in each phase during the current frame
+    uint64_t phase_micros[PROFILER_PHASE_COUNT];
+
+    // ring buffers of finished frames, in milliseconds
+    float phase_samples[PROFILER_PHASE_COUNT][PROFILER_SAMPLE_COUNT];
+    float gpu_samples[PROFILER_SAMPLE_COUNT];
+    size_t sample_index;
+    size_t sample_count;
+    size_t gpu_sample_index;
+    size_t gpu_sample_count;
+
+    bool gpu_timer_supported;
+    uint32_t gpu_queries[PROFILER_GPU_QUERY_COUNT];
+    bool gpu_query_pending[PROFILER_GPU_QUERY_COUNT];
+    uint64_t gpu_query_start[PROFILER_GPU_QUERY_COUNT];
+    uint32_t gpu_query_index;
+    bool gpu_query_active;
+
+    ProfilerTraceEvent* trace;
+    ProfilerTraceEvent gpu_trace[PROFILER_SAMPLE_COUNT];
+    size_t trace_index;
+    size_t trace_count;
+
+    RendererStats last_frame_stats;
+} Profiler;
+
+void profiler_init(Profiler* profiler);
+
+void profiler_free(Profiler* profiler);
+
+// Starts timing a frame, and the GPU timer query when the overlay is shown
+void profiler_begin_frame(Profiler* profiler);
+
+// Stores the frame's samples and collects timer queries that finished
+void profiler_end_frame(Profiler* profiler);
+
+void profiler_begin(Profiler* profiler, ProfilerPhase phase);
+
+void profiler_end(Profiler* profiler, ProfilerPhase phase);
+
+void profiler_startup_begin(ProfilerStartupPhase phase);
+
+void profiler_startup_end(ProfilerStartupPhase phase);
+
+// Marks startup as done, the time to it is kept as the startup metric
+void profiler_startup_interactive(void);
+
+// Logs the time spent in every startup phase
+void profiler_startup_report(void);
+
+/** Writes the recorded phases in the Chrome trace event format.
+ * The file can be opened with chrome://tracing or https://ui.perfetto.dev
+ *
+ * @return false if the file could not be written.
+ */
+bool profiler_dump_trace(Profiler* profiler, const char* path);
+
+// Pushes the overlay text with p50/p95/p99 per phase
+void mesh_push_profiler_overlay(Mesh* mesh, World* world);
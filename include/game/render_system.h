@@ -1,4 +1,14 @@
 #pragma once
+#include <stdint.h>
+
+#ifndef __EMSCRIPTEN__
+#include <glad/glad.h>
+#else
+#include <GLES3/gl3.h>
+#endif
+
+#include "rendering/render_queue.h"
+
 typedef struct World World;
 typedef struct Vector Vector;
 typedef struct Mesh Mesh;
@@ -7,10 +17,31 @@ typedef struct AnimationSystem AnimationSystem;
 
 void mesh_push_text(Mesh* mesh, World* world, UIElement* ui_element);
 
-void mesh_push_ui_element(Mesh* mesh, World* world, UIElement* ui_element);
+// Pushes text that doesn't live in the arena, styled like the given text element
+void mesh_push_string(Mesh* mesh, World* world, const char* text, const UIElement* ui_element);
 
-void mesh_push_ui_elements(Mesh* mesh, World* world, Vector* vec);
+// Like mesh_push_string, for text that changes every frame and isn't worth caching
+void mesh_push_transient_string(
+    Mesh* mesh,
+    World* world,
+    const char* text,
+    const UIElement* ui_element
+);
+
+void mesh_push_ui_element(Mesh* mesh, World* world, UIElement* ui_element);
 
 void mesh_push_animations(Mesh* mesh, World* world);
 
+// Render queue layers, drawn in this order
+enum {
+    // the board itself is cached in a render target and blitted underneath
+    RENDER_LAYER_HIGHLIGHT = 0,
+    RENDER_LAYER_DRAG,
+    RENDER_LAYER_ANIMATION,
+    RENDER_LAYER_DEBUG,
+};
+
+// State used by everything drawn with the main shader and the spritesheet
+RenderState render_state_main(World* world, uint8_t layer, GLenum primitive);
+
 void render_world(World* world);
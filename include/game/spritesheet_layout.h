@@ -0,0 +1,58 @@
+#pragma once
+
+// Layout of assets/spritesheet.png, shared by the game and the asset baker
+
+#define SPRITESHEET_WIDTH 1856
+#define SPRITESHEET_HEIGHT 724
+
+// Cards are laid out in a grid, the last column only holds the card back in its last row.
+// Offsets are in pixels from the top left of the PNG.
+#define CARD_SHEET_COL 14
+#define CARD_SHEET_ROW 4
+#define CARD_SHEET_WIDTH 127
+#define CARD_SHEET_HEIGHT 180
+#define CARD_SHEET_GAP_X 1
+#define CARD_SHEET_GAP_Y 1
+
+// Buttons are stacked in a single column right of the cards
+#define BUTTON_SHEET_ROW 3
+#define BUTTON_SHEET_WIDTH 62
+#define BUTTON_SHEET_HEIGHT 64
+#define BUTTON_SHEET_GAP_Y 1
+#define BUTTON_SHEET_OFFSET_X (CARD_SHEET_COL * (CARD_SHEET_WIDTH + CARD_SHEET_GAP_X) + 1)
+#define BUTTON_SHEET_OFFSET_Y \
+    (SPRITESHEET_HEIGHT - BUTTON_SHEET_ROW * (BUTTON_SHEET_HEIGHT + BUTTON_SHEET_GAP_Y) + 1)
+
+// The baked atlas repacks cards and buttons into cells with their borders extruded into
+// ATLAS_PADDING pixels on every side, so that ATLAS_LEVEL_COUNT mip levels don't bleed.
+// Cells are multiples of 2^(ATLAS_LEVEL_COUNT - 1), so every mip texel stays in one cell.
+#define ATLAS_PADDING 8
+#define ATLAS_LEVEL_COUNT 4
+#define ATLAS_ALIGNMENT (1 << (ATLAS_LEVEL_COUNT - 1))
+#define ATLAS_ALIGN(size) (((size) + ATLAS_ALIGNMENT - 1) & ~(ATLAS_ALIGNMENT - 1))
+#define ATLAS_CARD_CELL_WIDTH ATLAS_ALIGN(CARD_SHEET_WIDTH + 2 * ATLAS_PADDING)
+#define ATLAS_CARD_CELL_HEIGHT ATLAS_ALIGN(CARD_SHEET_HEIGHT + 2 * ATLAS_PADDING)
+#define ATLAS_BUTTON_CELL_WIDTH ATLAS_ALIGN(BUTTON_SHEET_WIDTH + 2 * ATLAS_PADDING)
+#define ATLAS_BUTTON_CELL_HEIGHT ATLAS_ALIGN(BUTTON_SHEET_HEIGHT + 2 * ATLAS_PADDING)
+// buttons take one more column right of the cards
+#define ATLAS_WIDTH (CARD_SHEET_COL * ATLAS_CARD_CELL_WIDTH + ATLAS_BUTTON_CELL_WIDTH)
+#define ATLAS_HEIGHT (CARD_SHEET_ROW * ATLAS_CARD_CELL_HEIGHT)
+
+// Glyphs are laid out in a grid of GLYPH_COL columns, starting at the offset
+#define GLYPH_OFFSET_X (13 * 128 + 1)
+#define GLYPH_OFFSET_Y 1
+#define GLYPH_COL 6
+#define GLYPH_ROW 16
+#define GLYPH_WIDTH 30
+#define GLYPH_HEIGHT 30
+#define GLYPH_GAP_X 2
+#define GLYPH_GAP_Y 2
+
+// The signed distance field atlas keeps the glyph grid, every cell padded against bleeding
+#define GLYPH_SDF_PADDING 2
+#define GLYPH_SDF_CELL_WIDTH (GLYPH_WIDTH + 2 * GLYPH_SDF_PADDING)
+#define GLYPH_SDF_CELL_HEIGHT (GLYPH_HEIGHT + 2 * GLYPH_SDF_PADDING)
+#define GLYPH_SDF_WIDTH (GLYPH_COL * GLYPH_SDF_CELL_WIDTH)
+#define GLYPH_SDF_HEIGHT (GLYPH_ROW * GLYPH_SDF_CELL_HEIGHT)
+// distance in spritesheet pixels that maps to the full 0..255 range
+#define GLYPH_SDF_SPREAD 4.0f
@@ -0,0 +1,83 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "core/vector.h"
+#include "rendering/color.h"
+#include "rendering/mesh.h"
+#include "rendering/sprite.h"
+
+// Everything the size and the glyph layout of a string depend on
+typedef struct TextStyle {
+    // size of a glyph before scaling, all glyphs of the font have the same size
+    float glyph_size;
+    float font_scaling;
+    float line_height_scaling;
+    float character_spacing_scaling;
+} TextStyle;
+
+// Where a string is drawn, the glyph layout is built for one placement at a time
+typedef struct TextPlacement {
+    float x, y, z;
+    Color color;
+} TextPlacement;
+
+typedef struct TextRun {
+    // hash of the string and its TextStyle, 0 for an unused run
+    uint64_t key;
+    uint32_t last_used;
+
+    // what the run was built for, compared on a key match so that collisions are misses
+    // char copy of the string, terminated but its size doesn't count the terminator
+    Vector text;
+    TextStyle style;
+
+    float width;
+    float height;
+
+    // glyph quads for placement, valid if built
+    bool built;
+    TextPlacement placement;
+    Mesh mesh;
+} TextRun;
+
+#define TEXT_CACHE_RUN_COUNT 32
+
+/** Measured sizes and prebuilt glyph quads of recently used strings.
+ * Static text is measured once and appended to a mesh with a copy of its vertices. Strings
+ * that change every frame would only evict the static runs, they go through text_layout_push.
+ */
+typedef struct TextCache {
+    TextRun runs[TEXT_CACHE_RUN_COUNT];
+    uint32_t clock;
+} TextCache;
+
+void text_cache_init(TextCache* cache);
+
+void text_cache_free(TextCache* cache);
+
+// Finds or measures the run of a string
+TextRun* text_cache_get(TextCache* cache, const char* text, TextStyle style);
+
+/** Appends the glyph quads of a string, laying them out only if the run isn't cached.
+ * The quads are flagged VERTEX_FLAG_SDF, characters must point into the glyph atlas.
+ */
+void text_cache_push(
+    TextCache* cache,
+    Mesh* mesh,
+    const Sprite characters[256],
+    const char* text,
+    TextStyle style,
+    TextPlacement placement
+);
+
+/** Lays the glyph quads of a string out straight into mesh, without a run.
+ * For strings that change every frame, flagged VERTEX_FLAG_SDF like text_cache_push.
+ */
+void text_layout_push(
+    Mesh* mesh,
+    const Sprite characters[256],
+    const char* text,
+    TextStyle style,
+    TextPlacement placement
+);
@@ -0,0 +1,64 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "core/vector.h"
+#include "game/animation.h"
+
+typedef struct World World;
+
+typedef void (*TimelineCallback)(World* world, uint32_t argument);
+
+typedef struct TimelineEvent {
+    // seconds on the timeline clock
+    double time;
+    TimelineCallback callback;
+    uint32_t argument;
+} TimelineEvent;
+
+/** Schedules the deal, win and autocomplete sequences.
+ * Animations are handed to the animation system straight away with a negative elapsed time,
+ * so they wait there (with their cards hidden) and are all evaluated in the same pass.
+ * Callbacks are kept sorted by time and fired by timeline_update.
+ */
+typedef struct Timeline {
+    double time;
+    // TimelineEvent sorted by time, events before next_event already fired
+    Vector events;
+    size_t next_event;
+} Timeline;
+
+Timeline timeline_init(void);
+
+void timeline_free(Timeline* timeline);
+
+// Drops every pending callback
+void timeline_clear(Timeline* timeline);
+
+void timeline_add_animation(
+    AnimationSystem* animation_system,
+    double delay,
+    const UIElementAnimation* animation
+);
+
+// Starts the animations one after another, interval seconds apart
+void timeline_add_stagger(
+    AnimationSystem* animation_system,
+    double delay,
+    double interval,
+    const UIElementAnimation* animations,
+    size_t count
+);
+
+void timeline_add_callback(
+    Timeline* timeline,
+    double delay,
+    TimelineCallback callback,
+    uint32_t argument
+);
+
+// Advances the clock and fires every callback that became due, in order
+void timeline_update(Timeline* timeline, World* world, double delta_time);
+
+// Seconds until the next callback, INFINITY if nothing is scheduled
+double timeline_time_to_next_event(const Timeline* timeline);
@@ -0,0 +1,45 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <cglm/struct.h>
+
+#include "core/vector.h"
+
+typedef struct UIElement UIElement;
+
+#define UI_HIT_GRID_COLUMNS 32
+#define UI_HIT_GRID_ROWS 18
+#define UI_HIT_GRID_CELLS (UI_HIT_GRID_COLUMNS * UI_HIT_GRID_ROWS)
+
+/** Uniform grid over the virtual screen, mapping each cell to the elements overlapping it.
+ * Cells are stored back to back (cell_start[c] to cell_start[c + 1] in indices), each
+ * sorted topmost first, so a query only tests the few elements under the pointer.
+ * It is rebuilt only when the layout changes.
+ */
+typedef struct UIHitGrid {
+    float cell_width;
+    float cell_height;
+    uint32_t cell_start[UI_HIT_GRID_CELLS + 1];
+    // uint16_t element indices
+    Vector indices;
+} UIHitGrid;
+
+UIHitGrid ui_hit_grid_init(void);
+
+void ui_hit_grid_free(UIHitGrid* grid);
+
+// Indexes the hitboxes of a layout
+void ui_hit_grid_build(UIHitGrid* grid, Vector* layout);
+
+/** Finds the topmost element of ui_elements under the point.
+ * ui_elements must be parallel to the layout the grid was built from. Their current hitboxes
+ * are tested, so elements that lost their hitbox (like dragged cards) are skipped.
+ */
+bool ui_hit_grid_query(
+    const UIHitGrid* grid,
+    Vector* ui_elements,
+    vec2s point,
+    UIElement* topmost,
+    size_t* index
+);
@@ -1,5 +1,6 @@
 #pragma once
 #include <stdbool.h>
+#include <stdint.h>
 
 #include <cglm/struct.h>
 
@@ -10,14 +11,43 @@ typedef struct Sprite Sprite;
 typedef struct Vector Vector;
 typedef struct UIElement UIElement;
 
+#define UI_CARD_LOOKUP_LOCATIONS 16
+// one cascade can hold up to 19 cards
+#define UI_CARD_LOOKUP_INDICES 20
+
+// Index of the UI_CARD element for each (SelectionLocation, card index), or -1
+typedef struct UICardLookup {
+    int16_t element_index[UI_CARD_LOOKUP_LOCATIONS][UI_CARD_LOOKUP_INDICES];
+} UICardLookup;
+
+// Finds the styled card element at a location through the scene's lookup table
 bool ui_find_in_layout(
-    Vector* vec,
+    World* world,
     SelectionLocation location,
     uint32_t card_index,
     UIElement* dest,
     size_t* dest_idx
 );
 
-void ui_push_world(Vector* vec, World* world);
+/** Pushes the elements of the world, filling lookup with the position of every card.
+ *
+ * @return index of the game info text, see ui_update_game_info.
+ */
+size_t ui_push_world(Vector* vec, UICardLookup* lookup, World* world);
 
-bool ui_get_topmost_hit(Vector* ui_elements, vec2s mouse, UIElement* topmost, size_t* index);
+/** Rewrites the game info text for the current clock without a new layout.
+ *
+ * @return true if the text changed.
+ */
+bool ui_update_game_info(World* world, UIElement* game_info);
+
+/** Finds the topmost element under the mouse through the scene's hit grid.
+ * ui_elements must be the current layout or the styled elements parallel to it.
+ */
+bool ui_get_topmost_hit(
+    World* world,
+    Vector* ui_elements,
+    vec2s mouse,
+    UIElement* topmost,
+    size_t* index
+);
@@ -0,0 +1,42 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "game/freecell.h"
+
+typedef struct World World;
+
+#define UI_LEGALITY_LOCATION_COUNT 16
+
+/** Answers to the rules questions the UI asks about every card, every frame.
+ * They only change with the position or the drag source, so they are computed once per
+ * change and hover-only frames do no rules evaluation at all.
+ */
+typedef struct UILegalityCache {
+    bool valid;
+
+    // what the cached answers were computed for
+    uint64_t position_hash;
+    bool dragging;
+    SelectionLocation drag_location;
+    uint8_t drag_index;
+
+    // bit k is set if the cards from index k onwards can be picked up from the location
+    uint32_t movable_from[UI_LEGALITY_LOCATION_COUNT];
+    // bit l is set if the dragged cards can be dropped on location l
+    uint16_t drop_targets;
+
+    bool game_over;
+    bool trivially_solved;
+} UILegalityCache;
+
+// Recomputes the cached answers if the position or the drag source changed
+void ui_legality_update(UILegalityCache* cache, World* world);
+
+bool ui_legality_can_move_from(
+    const UILegalityCache* cache,
+    SelectionLocation location,
+    uint32_t card_index
+);
+
+bool ui_legality_can_drop_on(const UILegalityCache* cache, SelectionLocation location);
@@ -0,0 +1,89 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "core/vector.h"
+#include "game/freecell.h"
+#include "game/ui_element.h"
+#include "game/ui_hit_grid.h"
+#include "game/ui_layout.h"
+#include "rendering/mesh.h"
+#include "rendering/render_target.h"
+
+typedef struct World World;
+
+// Everything the layout is derived from.
+// The layout is only rebuilt when this changes, the clock is patched into its slot instead.
+typedef struct UILayoutKey {
+    Freecell freecell;
+    // the foundations shown while the win sequence runs
+    Card game_over_foundation[4];
+    uint32_t seed;
+    size_t move_count;
+    bool show_help;
+    bool sound_enabled;
+} UILayoutKey;
+
+// A stable slot for one UIElement and the vertex range it owns in the retained mesh
+typedef struct UISceneSlot {
+    UIElement element;
+    uint32_t first_vertex;
+    uint32_t vertex_count;
+    bool hidden;
+    bool dirty;
+} UISceneSlot;
+
+typedef struct UIScene {
+    // Unstyled elements as produced by ui_push_world
+    Vector layout;
+    // One UISceneSlot per element, parallel to layout and world->ui_elements
+    Vector slots;
+    // Hitboxes of the layout, for ui_get_topmost_hit
+    UIHitGrid hit_grid;
+    // Card positions in the layout, for ui_find_in_layout
+    UICardLookup card_lookup;
+    // the game info text, rewritten in place when the clock ticks
+    size_t game_info_index;
+
+    UILayoutKey layout_key;
+    bool layout_dirty;
+
+    Mesh mesh;
+    GPUMesh gpu_mesh;
+
+    // the retained mesh drawn once, redrawn only after an upload or a resize
+    RenderTarget board_target;
+    bool board_dirty;
+
+    // Scratch mesh used to re-emit a single element
+    Mesh element_mesh;
+} UIScene;
+
+UIScene ui_scene_init(void);
+
+void ui_scene_free(UIScene* scene);
+
+/** Rebuilds the layout if anything it depends on changed since the last call.
+ * world->ui_elements is resized to match the new layout.
+ * Otherwise only the game info text is refreshed, so a clock tick re-emits a single slot.
+ *
+ * @return true if the layout was rebuilt.
+ */
+bool ui_scene_update_layout(UIScene* scene, World* world);
+
+/** Stores the styled element for a slot, marking the slot dirty if it changed.
+ * Hidden elements keep their vertex range but don't produce any fragments, so changes to an
+ * element that stays hidden are ignored.
+ */
+void ui_scene_sync_element(UIScene* scene, size_t index, const UIElement* element, bool hidden);
+
+/** Draws the retained mesh into the board target if it changed since the last call.
+ * The board is blitted to the screen every frame, with the dynamic layers drawn on top.
+ */
+void ui_scene_draw_board(UIScene* scene, World* world, int width, int height);
+
+/** Uploads the retained mesh.
+ * After a layout change the whole mesh is rebuilt, otherwise only dirty slots are
+ * re-emitted and their vertex ranges updated in place.
+ */
+void ui_scene_upload(UIScene* scene, World* world);
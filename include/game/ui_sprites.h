@@ -3,9 +3,15 @@
 
 typedef struct World World;
 
+// Texture blobs, see texture_blob.h
+// Premultiplied RGBA atlas of cards and buttons, ATLAS_WIDTH x ATLAS_HEIGHT with mip levels
 extern const char MAIN_SPRITESHEET[];
 extern const size_t MAIN_SPRITESHEET_SIZE;
 
+// Signed distance field of every glyph, GLYPH_SDF_WIDTH x GLYPH_SDF_HEIGHT single channel
+extern const char GLYPH_SDF_ATLAS[];
+extern const size_t GLYPH_SDF_ATLAS_SIZE;
+
 extern const char* ICON_GAME;
 extern const char* ICON_CLOCK;
 
@@ -7,6 +7,11 @@ typedef struct GLFWwindow GLFWwindow;
 
 bool ui_is_element_draggable(World* world, UIElement* elem);
 
+bool ui_is_element_dragged(World* world, const UIElement* ui_element);
+
+// Hover, selection and drop target styles, which follow the pointer from frame to frame
+bool ui_is_element_highlighted(const UIElement* ui_element);
+
 bool ui_set_dragged_element_properties(UIElement* ui_element, World* world);
 
 UIElement ui_get_new_state(
@@ -2,17 +2,25 @@
 #include <stdint.h>
 
 #include <cglm/struct.h>
-#include <miniaudio.h>
 
 #include "game/game.h"
 #include "game/animation.h"
 
 #include "rendering/camera.h"
 #include "rendering/mesh.h"
+#include "rendering/render_queue.h"
 #include "rendering/sprite.h"
+#include "rendering/uniform_buffer.h"
 
 #include "game/assets.h"
+#include "game/audio.h"
 #include "game/controller.h"
+#include "game/frame_scheduler.h"
+#include "game/profiler.h"
+#include "game/text_cache.h"
+#include "game/timeline.h"
+#include "game/ui_legality.h"
+#include "game/ui_scene.h"
 
 extern const Color BACKGROUND_COLOR;
 
@@ -21,32 +29,41 @@ typedef struct World {
     Game game;
 
     Camera camera;
+    // the camera as seen by the shaders, see world_upload_camera
+    UniformBuffer camera_buffer;
     Assets assets;
 
     Sprite deck[54];
     Sprite characters[256];
+    TextCache text_cache;
 
     Sprite button_undo;
     Sprite button_new_game;
     Sprite button_sound;
 
+    // Styled elements of the current frame, one per ui_scene slot
     Vector ui_elements;
+    UIScene ui_scene;
+    UILegalityCache ui_legality;
 
-    GPUMesh game_gpu_mesh;
-    Mesh game_mesh;
+    RenderQueue render_queue;
 
     bool sound_enabled;
-    ma_engine engine;
+    Audio audio;
 
     bool show_help;
 
-    ma_decoder card_move_decoder;
-    ma_sound card_move_sound;
-
     Controller controller;
     AnimationSystem animation_system;
+    Timeline timeline;
+
+    Profiler profiler;
+    FrameScheduler frame_scheduler;
 } World;
 
 World world_init(RGFW_window* window);
 
 void world_free(World* world);
+
+// Copies the camera into its uniform buffer, needed after every change to it
+void world_upload_camera(World* world);
@@ -46,6 +46,11 @@ void window_queue_close(RGFW_window*);
 
 bool window_is_queued_to_close(RGFW_window* window);
 
+bool window_is_minimized(RGFW_window* window);
+
 bool window_get_event(RGFW_window* window, RGFW_event* event);
 
 void event_wait_timeout(uint32_t waitMS);
+
+// Blocks until the next event arrives
+void event_wait(void);
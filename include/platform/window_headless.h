@@ -0,0 +1,10 @@
+#pragma once
+#include <stdint.h>
+
+typedef struct RGFW_window RGFW_window;
+
+/** Copies the last frame drawn into rgba, which holds width * height * 4 bytes.
+ * Rows are stored top to bottom, like an image file.
+ * Only available in the headless build, where the window is an offscreen render target.
+ */
+void window_read_pixels(RGFW_window* window, uint8_t* rgba);
@@ -1,8 +1,13 @@
 #pragma once
 
+#include <assert.h>
+
 #include <cglm/cglm.h>
 
+// Uploaded as is to the std140 Camera uniform block of the shaders
 typedef struct Camera {
     mat4 projection;
     mat4 view;
 } Camera;
+
+static_assert(sizeof(Camera) == 2 * 16 * sizeof(float), "Camera must match its std140 block");
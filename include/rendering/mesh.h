@@ -3,13 +3,26 @@
 #include "rendering/primitives.h"
 #include "rendering/sprite.h"
 
+#include <stdbool.h>
 #include <stdint.h>
 
+typedef uint16_t VertexFlags;
+enum {
+    // The spritesheet is not sampled, only the vertex color is used
+    VERTEX_FLAG_UNTEXTURED = 1 << 0,
+    // The glyph atlas is sampled as a signed distance field instead of the spritesheet
+    VERTEX_FLAG_SDF = 1 << 1,
+};
+
+// Color is RGBA8 and tex coords are 16 bit, both normalized by the GPU.
+// Depth only orders sprites (0 for the board, 10 for dragged cards), so a short is plenty.
 #pragma pack(push, 1)
 typedef struct Vertex {
-    float x, y, z;
-    float r, g, b, a;
-    float u, v;
+    float x, y;
+    int16_t z;
+    VertexFlags flags;
+    uint8_t r, g, b, a;
+    uint16_t u, v;
 } Vertex;
 #pragma pack(pop)
 
@@ -18,19 +31,47 @@ typedef struct Mesh {
     Vector indices;
 } Mesh;
 
+#define GPU_MESH_RING_SECTIONS 3
+
 typedef struct GPUMesh {
     uint32_t VAO;
     uint32_t VBO;
     uint32_t EBO;
     size_t index_count;
+    // first index to draw, in indices
+    size_t index_offset;
+
+    // allocated buffer sizes in bytes, only grown
+    size_t vertex_buffer_size;
+    size_t index_buffer_size;
+
+    // Streaming meshes write straight into persistently mapped buffers split into
+    // GPU_MESH_RING_SECTIONS sections, each section guarded by a fence.
+    bool streaming;
+    uint32_t section;
+    size_t section_vertex_capacity;
+    size_t section_index_capacity;
+    uint8_t* mapped_vertices;
+    uint8_t* mapped_indices;
+    void* fences[GPU_MESH_RING_SECTIONS];
 } GPUMesh;
 
+void vertex_set_position(Vertex* vertex, float x, float y, float z);
+
+void vertex_set_color(Vertex* vertex, Color color);
+
+// Non finite tex coords mark the vertex as untextured
+void vertex_set_tex_coords(Vertex* vertex, float u, float v);
+
 Mesh mesh_init();
 
 void mesh_clear(Mesh* mesh);
 
 void mesh_free(Mesh* mesh);
 
+// Appends a copy of src, its indices are rebased onto the vertices already in mesh
+void mesh_append(Mesh* mesh, const Mesh* src);
+
 void mesh_push_line(Mesh* mesh, Line line);
 
 void mesh_push_triangle(Mesh* mesh, Triangle triangle);
@@ -45,6 +86,23 @@ void mesh_push_sprite(Mesh* mesh, Sprite sprite);
 
 GPUMesh gpu_mesh_init();
 
+/** Creates a mesh meant to be re-uploaded every frame.
+ * Uses a persistently mapped ring buffer where buffer storage is available (desktop GL 4.4 or
+ * ARB_buffer_storage), and falls back to a regular orphaning mesh elsewhere (WebGL2).
+ */
+GPUMesh gpu_mesh_init_streaming();
+
 void gpu_mesh_free(GPUMesh* mesh);
 
 void gpu_mesh_upload(GPUMesh* gpu_mesh, Mesh* mesh);
+
+// Marks the section drawn last as in use by the GPU, called after the draw is submitted
+void gpu_mesh_fence(GPUMesh* gpu_mesh);
+
+// Updates a vertex range in place, the mesh must already have been uploaded with the same layout
+void gpu_mesh_upload_vertices(
+    GPUMesh* gpu_mesh,
+    Mesh* mesh,
+    size_t first_vertex,
+    size_t vertex_count
+);
@@ -0,0 +1,80 @@
+#pragma once
+#include <stdint.h>
+
+#ifndef __EMSCRIPTEN__
+#include <glad/glad.h>
+#else
+#include <GLES3/gl3.h>
+#endif
+
+#include "core/vector.h"
+#include "rendering/mesh.h"
+
+typedef enum BlendMode {
+    BLEND_NONE = 0,
+    BLEND_ALPHA,
+} BlendMode;
+
+// Everything a draw depends on, packed into the sort key of a RenderItem
+typedef struct RenderState {
+    uint8_t layer;
+    uint32_t shader;
+    uint32_t texture;
+    BlendMode blend;
+    GLenum primitive;
+} RenderState;
+
+/** Sort key layout, most significant first:
+ * layer (8) | shader (16) | texture (16) | blend (4) | primitive (4) | sequence (16)
+ * Sequence keeps items with equal state in submission order.
+ */
+typedef uint64_t RenderKey;
+
+typedef struct RenderItem {
+    RenderKey key;
+    RenderState state;
+    // Retained mesh to draw, or NULL for geometry in the queue's own mesh
+    GPUMesh* gpu_mesh;
+    size_t first_index;
+    size_t index_count;
+} RenderItem;
+
+typedef struct RenderQueue {
+    Vector items;
+    Vector sorted_items;
+
+    // Transient geometry, pushed by the caller and submitted with render_queue_submit
+    Mesh mesh;
+    size_t submitted_indices;
+
+    // Transient geometry with indices reordered by sort key
+    Mesh batch_mesh;
+    GPUMesh gpu_mesh;
+
+    // Draw calls issued by the last flush
+    uint32_t draw_calls;
+} RenderQueue;
+
+RenderQueue render_queue_init(void);
+
+void render_queue_free(RenderQueue* queue);
+
+RenderKey render_key(RenderState state, uint16_t sequence);
+
+// Mesh to push transient geometry into, before calling render_queue_submit
+Mesh* render_queue_mesh(RenderQueue* queue);
+
+// Records everything pushed into the queue mesh since the last submit as one item
+void render_queue_submit(RenderQueue* queue, RenderState state);
+
+// Records a draw of a retained mesh, it must stay alive until the next flush
+void render_queue_push_mesh(RenderQueue* queue, GPUMesh* gpu_mesh, RenderState state);
+
+// Sorts the items by key in place, items with equal keys keep their order
+void render_queue_sort(RenderQueue* queue);
+
+/** Sorts the items and draws them.
+ * Neighbouring transient items with the same state are merged into a single draw call,
+ * and render state is only changed between items that differ.
+ */
+void render_queue_flush(RenderQueue* queue);
@@ -0,0 +1,37 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+// An offscreen color and depth buffer the size of the window
+typedef struct RenderTarget {
+    uint32_t framebuffer;
+    uint32_t color;
+    uint32_t depth;
+    int width;
+    int height;
+} RenderTarget;
+
+// The target is empty until the first render_target_resize
+RenderTarget render_target_init(void);
+
+void render_target_free(RenderTarget* target);
+
+/** Recreates the buffers if the size changed, the contents are undefined afterwards.
+ *
+ * @return true if the buffers were recreated.
+ */
+bool render_target_resize(RenderTarget* target, int width, int height);
+
+// Redirects drawing into the target until render_target_unbind
+void render_target_bind(RenderTarget* target);
+
+// Binds the default framebuffer again
+void render_target_unbind(void);
+
+/** Replaces framebuffer 0 as the one drawn to outside of any render target.
+ * Used by the headless window, whose context has no framebuffer of its own.
+ */
+void render_target_set_default_framebuffer(uint32_t framebuffer);
+
+// Copies the color buffer onto the window, covering all of it
+void render_target_blit_to_screen(RenderTarget* target);
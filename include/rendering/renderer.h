@@ -9,15 +9,40 @@
 #include "rendering/color.h"
 #include "rendering/mesh.h"
 
+// Work submitted to the GPU since the last renderer_stats_reset
+typedef struct RendererStats {
+    uint32_t draw_calls;
+    uint32_t indices_drawn;
+    uint32_t vertices_uploaded;
+    size_t bytes_uploaded;
+} RendererStats;
+
+extern RendererStats renderer_stats;
+
+void renderer_stats_reset(void);
+
 void renderer_init(void);
 
 void renderer_clear(Color clear_color);
 
+void renderer_clear_depth(void);
+
+// Blended geometry is drawn without writing depth, so transparent texels never hide anything
+void renderer_set_depth_write(bool enabled);
+
 void renderer_set_shader(uint32_t shader);
 
 void renderer_bind_texture(uint32_t slot, GLenum target, uint32_t texture);
 
 void renderer_draw_mesh(GPUMesh* mesh, GLenum primitive);
 
+// Draws index_count indices starting at first_index, without fencing streaming meshes
+void renderer_draw_mesh_range(
+    GPUMesh* mesh,
+    GLenum primitive,
+    size_t first_index,
+    size_t index_count
+);
+
 void openglDebugCallback(GLenum source, GLenum type, GLuint id, GLenum severity,
     GLsizei length, const GLchar* message, const void* userParam);
@@ -1,14 +1,57 @@
 #pragma once
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
-typedef uint32_t Shader;
+#define SHADER_MAX_UNIFORMS 16
+#define SHADER_UNIFORM_NAME_LENGTH 32
 
-Shader shader_init(const char* vertex_shader_source, const char* fragment_shader_source);
+// An active uniform outside of uniform blocks, as reported by the linked program
+typedef struct ShaderUniformInfo {
+    char name[SHADER_UNIFORM_NAME_LENGTH];
+    int32_t location;
+    // GL type, e.g. GL_FLOAT_MAT4 or GL_SAMPLER_2D
+    uint32_t type;
+} ShaderUniformInfo;
+
+/** A linked program and the locations of its uniforms.
+ * Every active uniform is reflected once after linking. Uniforms named in shader_init are
+ * then set by their index in that list, so setting one never looks its name up.
+ */
+typedef struct Shader {
+    uint32_t program;
+
+    ShaderUniformInfo uniforms[SHADER_MAX_UNIFORMS];
+    size_t uniform_count;
+
+    // locations of the uniforms named in shader_init, -1 if one isn't active
+    int32_t uniform_locations[SHADER_MAX_UNIFORMS];
+} Shader;
+
+/** Loads the program from the shader cache, or compiles and links it and caches the binary.
+ *
+ * @return a shader with program 0 if compiling or linking failed.
+ */
+Shader shader_init(
+    const char* vertex_shader_source,
+    const char* fragment_shader_source,
+    const char* const* uniform_names,
+    size_t uniform_count
+);
 
 void shader_free(Shader* shader);
 
-void shader_set_int(Shader shader, const char* name, int value);
+// Location of an active uniform from the reflected table, -1 if there is none
+int32_t shader_uniform_location(const Shader* shader, const char* name);
+
+/** Attaches a uniform block of the program to a binding point, see uniform_buffer.h.
+ *
+ * @return false if the program has no such block.
+ */
+bool shader_bind_uniform_block(const Shader* shader, const char* name, uint32_t binding);
+
+void shader_set_int(const Shader* shader, uint32_t uniform, int value);
 
-void shader_set_float(Shader shader, const char* name, float value);
+void shader_set_float(const Shader* shader, uint32_t uniform, float value);
 
-void shader_set_mat4(Shader shader, const char* name, const float* value);
+void shader_set_mat4(const Shader* shader, uint32_t uniform, const float* value);
@@ -0,0 +1,24 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+/** On-disk cache of a linked program binary.
+ * One binary is kept, in a freecell directory of the per-user cache directory. It is only
+ * reused for the same sources on the driver that produced it, anything else overwrites it.
+ * The web build has no program binaries, every function is a no-op there.
+ */
+
+// Hash of the driver strings and both sources, a cached binary is only loaded if it matches
+uint64_t shader_cache_key(const char* vertex_shader_source, const char* fragment_shader_source);
+
+// Whether the driver can retrieve and load program binaries at all
+bool shader_cache_supported(void);
+
+/** Creates a program from the cached binary, if it was stored under key.
+ *
+ * @return the linked program, or 0 if there is no usable binary.
+ */
+uint32_t shader_cache_load(uint64_t key);
+
+// Writes the binary of a linked program, failures only mean the next launch compiles again
+void shader_cache_store(uint32_t program, uint64_t key);
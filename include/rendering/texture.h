@@ -1,4 +1,5 @@
 #pragma once
+#include <stddef.h>
 #include <stdint.h>
 
 #include "rendering/image.h"
@@ -7,4 +8,7 @@ typedef uint32_t Texture;
 
 uint32_t texture_init(Image* image);
 
+// Uploads a blob baked by tools/asset_baker, see texture_blob.h
+uint32_t texture_init_from_blob(const uint8_t* blob, size_t size);
+
 void texture_free(uint32_t* texture);
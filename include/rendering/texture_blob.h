@@ -0,0 +1,17 @@
+#pragma once
+#include <stdint.h>
+
+// Texture blobs are written by tools/asset_baker and uploaded without any decoding.
+// The header is followed by level_count levels, each half the size of the previous one
+// (at least 1 pixel), rows tightly packed from the bottom up.
+
+#define TEXTURE_BLOB_MAGIC 0x58544346u // "FCTX"
+
+typedef struct TextureBlobHeader {
+    uint32_t magic;
+    uint32_t width;
+    uint32_t height;
+    // bytes per pixel, 1 (R8) or 4 (RGBA8)
+    uint32_t channels;
+    uint32_t level_count;
+} TextureBlobHeader;
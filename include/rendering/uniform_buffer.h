@@ -0,0 +1,22 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// Uniform blocks are bound to these points, see shader_bind_uniform_block
+typedef enum UniformBinding {
+    UNIFORM_BINDING_CAMERA = 0,
+} UniformBinding;
+
+// A std140 uniform buffer attached to a fixed binding point
+typedef struct UniformBuffer {
+    uint32_t buffer;
+    size_t size;
+    uint32_t binding;
+} UniformBuffer;
+
+UniformBuffer uniform_buffer_init(size_t size, uint32_t binding);
+
+void uniform_buffer_free(UniformBuffer* uniform_buffer);
+
+// Replaces the contents, data has to match the std140 layout of the block
+void uniform_buffer_update(UniformBuffer* uniform_buffer, const void* data, size_t size);
@@ -1,5 +1,7 @@
 #pragma once
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
 #include <cglm/struct.h>
 
@@ -12,8 +14,16 @@ uint64_t time_millis();
 
 uint64_t time_millis_from_start();
 
+uint64_t time_micros();
+
+// FNV-1a
+uint64_t hash_bytes(const void* data, size_t size);
+
 bool point_in_rect(float px, float py, Rect rect);
 
+// Rects are centered on x and y, like hitboxes
+bool rects_overlap(Rect a, Rect b);
+
 vec2s screen_to_world(
     double mouse_x,
     double mouse_y,
@@ -0,0 +1,275 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+#include "core/aalloc.h"
+#include "core/log.h"
+#include "platform/window.h"
+#include "platform/window_headless.h"
+#include "rendering/image.h"
+#include "rendering/renderer.h"
+
+#include "game/constants.h"
+#include "game/controller.h"
+#include "game/profiler.h"
+#include "game/world.h"
+#include "utils.h"
+
+// Every frame advances the game by the same step, so the captured frames are reproducible
+#define BENCH_FRAME_TIME (1.0 / 60.0)
+// Upper bound on the frames spent waiting for the deal animation to finish
+#define BENCH_SETTLE_FRAMES 1200
+#define BENCH_FRAMES 300
+#define BENCH_SEED 1
+
+// A channel may differ this much from the golden image, drivers don't rasterize identically
+#define BENCH_CHANNEL_TOLERANCE 8
+// Fraction of pixels allowed to exceed the tolerance
+#define BENCH_MISMATCH_FRACTION 0.001
+
+typedef struct BenchScene {
+    const char* name;
+    void (*setup)(World* world);
+    // rebuild and upload the whole retained mesh every frame, instead of only patching it
+    bool full_rebuild;
+} BenchScene;
+
+static void bench_setup_dealt(World* world) { controller_new_game_with_seed(world, BENCH_SEED); }
+
+static const BenchScene BENCH_SCENES[] = {
+    { .name = "dealt", .setup = bench_setup_dealt },
+    { .name = "dealt_rebuild", .setup = bench_setup_dealt, .full_rebuild = true },
+    { .name = "full_cascades", .setup = controller_fill_cascades },
+    { .name = "full_cascades_rebuild", .setup = controller_fill_cascades, .full_rebuild = true },
+};
+
+static void bench_frame(World* world) {
+    profiler_begin_frame(&world->profiler);
+    controller_update(world, BENCH_FRAME_TIME);
+
+    profiler_begin(&world->profiler, PROFILER_PHASE_SWAP);
+    window_swap_buffers(world->window);
+    profiler_end(&world->profiler, PROFILER_PHASE_SWAP);
+    profiler_end_frame(&world->profiler);
+}
+
+// Runs frames until nothing is animated or scheduled anymore
+static void bench_settle(World* world) {
+    for (int i = 0; i < BENCH_SETTLE_FRAMES; i++) {
+        if (animation_system_count(&world->animation_system) == 0
+            && isinf(timeline_time_to_next_event(&world->timeline))) {
+            break;
+        }
+        bench_frame(world);
+    }
+    // the last update may have changed the game, draw it once more
+    bench_frame(world);
+}
+
+// Drops the alpha channel in place, the frames are compared and stored as RGB
+static void bench_pack_rgb(uint8_t* pixels, int width, int height) {
+    for (size_t i = 0; i < (size_t)width * height; i++) {
+        pixels[i * 3 + 0] = pixels[i * 4 + 0];
+        pixels[i * 3 + 1] = pixels[i * 4 + 1];
+        pixels[i * 3 + 2] = pixels[i * 4 + 2];
+    }
+}
+
+static bool bench_write_png(const char* path, const uint8_t* rgb, int width, int height) {
+    if (!stbi_write_png(path, width, height, 3, rgb, width * 3)) {
+        log_error("Failed to write %s", path);
+        return false;
+    }
+    return true;
+}
+
+/** Compares the frame against a golden image written by bench_write_png.
+ *
+ * @return false if the golden image is missing or differs from the frame.
+ */
+static bool bench_compare_golden(const char* path, const uint8_t* rgb, int width, int height) {
+    Image golden = image_load(path, 3);
+    if (!golden.data) {
+        log_error("Failed to load the golden image %s: %s", path, image_get_error_msg());
+        return false;
+    }
+    if (golden.width != width || golden.height != height) {
+        log_error(
+            "%s is %dx%d, the frame is %dx%d",
+            path,
+            golden.width,
+            golden.height,
+            width,
+            height
+        );
+        image_free(&golden);
+        return false;
+    }
+
+    size_t mismatched = 0;
+    for (int y = 0; y < height; y++) {
+        // image_load flips the rows for GL, the frame is stored top to bottom
+        const uint8_t* golden_row = golden.data + (size_t)(height - 1 - y) * width * 3;
+        const uint8_t* frame_row = rgb + (size_t)y * width * 3;
+        for (int x = 0; x < width; x++) {
+            for (int channel = 0; channel < 3; channel++) {
+                if (abs(golden_row[x * 3 + channel] - frame_row[x * 3 + channel])
+                    > BENCH_CHANNEL_TOLERANCE) {
+                    mismatched++;
+                    break;
+                }
+            }
+        }
+    }
+    image_free(&golden);
+
+    size_t pixel_count = (size_t)width * height;
+    if (mismatched > pixel_count * BENCH_MISMATCH_FRACTION) {
+        log_error("%s: %zu of %zu pixels differ", path, mismatched, pixel_count);
+        return false;
+    }
+    return true;
+}
+
+static int bench_compare_micros(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static void bench_measure(World* world, const BenchScene* scene) {
+    static uint64_t frame_micros[BENCH_FRAMES];
+    uint64_t build_micros = 0;
+    uint64_t upload_micros = 0;
+    uint64_t draw_micros = 0;
+    size_t bytes_uploaded = 0;
+    uint32_t draw_calls = 0;
+
+    Profiler* profiler = &world->profiler;
+    for (int i = 0; i < BENCH_FRAMES; i++) {
+        if (scene->full_rebuild) {
+            world->ui_scene.layout_dirty = true;
+        }
+
+        uint64_t start = time_micros();
+        bench_frame(world);
+        frame_micros[i] = time_micros() - start;
+
+        build_micros += profiler->phase_micros[PROFILER_PHASE_LAYOUT]
+            + profiler->phase_micros[PROFILER_PHASE_UI_STATE]
+            + profiler->phase_micros[PROFILER_PHASE_MESH_BUILD];
+        upload_micros += profiler->phase_micros[PROFILER_PHASE_UPLOAD];
+        draw_micros += profiler->phase_micros[PROFILER_PHASE_DRAW];
+        bytes_uploaded += profiler->last_frame_stats.bytes_uploaded;
+        draw_calls += profiler->last_frame_stats.draw_calls;
+    }
+
+    qsort(frame_micros, BENCH_FRAMES, sizeof(uint64_t), bench_compare_micros);
+    uint64_t total_micros = 0;
+    for (int i = 0; i < BENCH_FRAMES; i++) {
+        total_micros += frame_micros[i];
+    }
+
+    // the bytes include the queue's stream, which is uploaded while drawing and not timed here
+    double upload_seconds = upload_micros / 1000000.0;
+    double megabytes_per_second =
+        upload_seconds > 0.0 ? bytes_uploaded / (1024.0 * 1024.0) / upload_seconds : 0.0;
+
+    log_info(
+        "%-22s frame %7.3f ms  p95 %7.3f ms  build %7.3f ms  upload %7.3f ms  draw %7.3f ms  "
+        "%8.1f MB/s  %5.1f KB/frame  %u draws/frame",
+        scene->name,
+        total_micros / 1000.0 / BENCH_FRAMES,
+        frame_micros[BENCH_FRAMES * 95 / 100] / 1000.0,
+        build_micros / 1000.0 / BENCH_FRAMES,
+        upload_micros / 1000.0 / BENCH_FRAMES,
+        draw_micros / 1000.0 / BENCH_FRAMES,
+        megabytes_per_second,
+        bytes_uploaded / 1024.0 / BENCH_FRAMES,
+        draw_calls / BENCH_FRAMES
+    );
+}
+
+/** Renders fixed scenes without a display, for CI.
+ * Usage: freecell_bench [output directory] [golden directory]
+ *
+ * Every scene is written to the output directory as <scene>.png and compared against the image
+ * of the same name in the golden directory, if one is given. The golden images in tests/golden
+ * were rendered by Mesa's llvmpipe, copy the output over them when a change is intended.
+ * The startup phases are logged once, then frame, mesh build, upload and draw times and upload
+ * throughput per scene.
+ */
+int main(int argc, char** argv) {
+    const char* output_dir = argc > 1 ? argv[1] : ".";
+    const char* golden_dir = argc > 2 ? argv[2] : NULL;
+
+    // animations pick random offsets, keep them the same on every run
+    srand(BENCH_SEED);
+
+    profiler_startup_begin(PROFILER_STARTUP_WINDOW);
+    RGFW_window* window = window_init((WindowConfig) {
+        .width = VIRTUAL_WIDTH,
+        .height = VIRTUAL_HEIGHT,
+        .min_width = -1,
+        .min_height = -1,
+        .max_width = -1,
+        .max_height = -1,
+        .title = GAME_TITLE,
+        .vsync = false,
+    });
+    profiler_startup_end(PROFILER_STARTUP_WINDOW);
+    log_info(
+        "Renderer: %s, %s",
+        (const char*)glGetString(GL_RENDERER),
+        (const char*)glGetString(GL_VERSION)
+    );
+
+    renderer_init();
+    World world = world_init(window);
+    world.sound_enabled = false;
+
+    int width, height;
+    window_get_size(window, &width, &height);
+    controller_on_framebuffer_resize(&world, width, height);
+
+    // startup ends with the first frame here, CI machines have no audio device to open
+    profiler_startup_begin(PROFILER_STARTUP_FIRST_FRAME);
+    bench_frame(&world);
+    profiler_startup_end(PROFILER_STARTUP_FIRST_FRAME);
+    profiler_startup_interactive();
+    profiler_startup_report();
+
+    uint8_t* pixels = malloc((size_t)width * height * 4);
+    if (!pixels) {
+        log_error("Failed to allocate the frame readback");
+        exit(EXIT_FAILURE);
+    }
+
+    bool passed = true;
+    for (size_t i = 0; i < sizeof(BENCH_SCENES) / sizeof(BenchScene); i++) {
+        const BenchScene* scene = &BENCH_SCENES[i];
+        scene->setup(&world);
+        bench_settle(&world);
+
+        char path[512];
+        window_read_pixels(window, pixels);
+        bench_pack_rgb(pixels, width, height);
+        snprintf(path, sizeof(path), "%s/%s.png", output_dir, scene->name);
+        passed &= bench_write_png(path, pixels, width, height);
+        if (golden_dir) {
+            snprintf(path, sizeof(path), "%s/%s.png", golden_dir, scene->name);
+            passed &= bench_compare_golden(path, pixels, width, height);
+        }
+
+        bench_measure(&world, scene);
+    }
+
+    free(pixels);
+    afree();
+    world_free(&world);
+    window_free(window);
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
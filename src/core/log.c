@@ -13,3 +13,14 @@ void log_error(const char* message, ...) {
 
     va_end(args);
 }
+
+void log_info(const char* message, ...) {
+    va_list args;
+    va_start(args, message);
+
+    fprintf(stderr, "INFO: ");
+    vfprintf(stderr, message, args);
+    fprintf(stderr, "\n");
+
+    va_end(args);
+}
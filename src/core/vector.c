@@ -22,12 +22,18 @@ void vec_free(Vector* vector) {
 
 Vector vec_ensure_capacity(Vector* vector, size_t capacity) {
     if (vector->capacity < capacity) {
-        void* new_data = realloc(vector->data, capacity * vector->elem_size);
+        // grow geometrically so that pushing into a cleared vector doesn't realloc every time
+        size_t new_capacity = vector->capacity ? vector->capacity * 2 : 8;
+        if (new_capacity < capacity) {
+            new_capacity = capacity;
+        }
+
+        void* new_data = realloc(vector->data, new_capacity * vector->elem_size);
         if (!new_data) {
             exit(EXIT_FAILURE);
         }
         vector->data = new_data;
-        vector->capacity = vector->capacity;
+        vector->capacity = new_capacity;
     }
     return *vector;
 }
@@ -71,7 +77,7 @@ void vec_delete(Vector* vector, size_t i) {
         memmove(
             (uint8_t*)vector->data + i * vector->elem_size,
             (uint8_t*)vector->data + (i + 1) * vector->elem_size,
-            (vector->size - i) * vector->elem_size
+            (vector->size - i - 1) * vector->elem_size
         );
     }
     vector->size -= 1;
@@ -1,92 +1,464 @@
+#include <math.h>
+#include <string.h>
+
 #include "utils.h"
 
 #include "game/animation.h"
 #include "game/controller.h"
 
+// The kernel works on 4 animations at a time, arrays are padded to a multiple of this
+#define ANIMATION_LANES 4
+
+#define ANIMATION_NO_SLOT UINT32_MAX
+
 AnimationSystem animation_system_init(void) {
-    AnimationSystem system = {
-        .ui_animations = vec_init(sizeof(UIElementAnimation)),
-    };
+    AnimationSystem system = { 0 };
+    for (size_t c = 0; c < ANIMATION_CHANNEL_COUNT; c++) {
+        system.from[c] = vec_init(sizeof(float));
+        system.to[c] = vec_init(sizeof(float));
+        system.current[c] = vec_init(sizeof(float));
+    }
+    system.elapsed = vec_init(sizeof(float));
+    system.duration = vec_init(sizeof(float));
+    system.behaviour = vec_init(sizeof(UIElementAnimationEndBehaviour));
+    system.templates = vec_init(sizeof(UIElement));
+    system.targets = vec_init(sizeof(AnimationTarget));
+    system.dense_slots = vec_init(sizeof(uint32_t));
+    system.slots = vec_init(sizeof(AnimationSlot));
+    system.free_slot = ANIMATION_NO_SLOT;
     return system;
 }
 
-void animation_system_free(AnimationSystem* system) { vec_free(&system->ui_animations); }
+void animation_system_free(AnimationSystem* system) {
+    for (size_t c = 0; c < ANIMATION_CHANNEL_COUNT; c++) {
+        vec_free(&system->from[c]);
+        vec_free(&system->to[c]);
+        vec_free(&system->current[c]);
+    }
+    vec_free(&system->elapsed);
+    vec_free(&system->duration);
+    vec_free(&system->behaviour);
+    vec_free(&system->templates);
+    vec_free(&system->targets);
+    vec_free(&system->dense_slots);
+    vec_free(&system->slots);
+    system->free_slot = ANIMATION_NO_SLOT;
+    system->ui_animation_count = 0;
+}
 
-UIElement animation_system_get_next_frame(AnimationSystem* system, UIElementAnimation* animation) {
-    UIElement result = animation->from;
+static void animation_channels_from_element(const UIElement* element, float* channels) {
+    channels[ANIMATION_CHANNEL_X] = element->sprite.x;
+    channels[ANIMATION_CHANNEL_Y] = element->sprite.y;
+    channels[ANIMATION_CHANNEL_Z] = element->sprite.z;
+    channels[ANIMATION_CHANNEL_ROTATION] = element->sprite.rotation;
+    channels[ANIMATION_CHANNEL_R] = element->sprite.color.r;
+    channels[ANIMATION_CHANNEL_G] = element->sprite.color.g;
+    channels[ANIMATION_CHANNEL_B] = element->sprite.color.b;
+    channels[ANIMATION_CHANNEL_A] = element->sprite.color.a;
+    channels[ANIMATION_CHANNEL_WIDTH] = element->sprite.width;
+    channels[ANIMATION_CHANNEL_HEIGHT] = element->sprite.height;
+    channels[ANIMATION_CHANNEL_HITBOX_X] = element->hitbox.x;
+    channels[ANIMATION_CHANNEL_HITBOX_Y] = element->hitbox.y;
+    channels[ANIMATION_CHANNEL_HITBOX_WIDTH] = element->hitbox.width;
+    channels[ANIMATION_CHANNEL_HITBOX_HEIGHT] = element->hitbox.height;
+}
 
-    float factor = (animation->duration > 0.0f) ? animation->elapsed / animation->duration : 1.0f;
-    factor = ease_in_out_cubic(factor);
+static void animation_channels_to_element(const float* channels, UIElement* element) {
+    element->sprite.x = channels[ANIMATION_CHANNEL_X];
+    element->sprite.y = channels[ANIMATION_CHANNEL_Y];
+    element->sprite.z = channels[ANIMATION_CHANNEL_Z];
+    element->sprite.rotation = channels[ANIMATION_CHANNEL_ROTATION];
+    element->sprite.color.r = channels[ANIMATION_CHANNEL_R];
+    element->sprite.color.g = channels[ANIMATION_CHANNEL_G];
+    element->sprite.color.b = channels[ANIMATION_CHANNEL_B];
+    element->sprite.color.a = channels[ANIMATION_CHANNEL_A];
+    element->sprite.width = channels[ANIMATION_CHANNEL_WIDTH];
+    element->sprite.height = channels[ANIMATION_CHANNEL_HEIGHT];
+    element->hitbox.x = channels[ANIMATION_CHANNEL_HITBOX_X];
+    element->hitbox.y = channels[ANIMATION_CHANNEL_HITBOX_Y];
+    element->hitbox.width = channels[ANIMATION_CHANNEL_HITBOX_WIDTH];
+    element->hitbox.height = channels[ANIMATION_CHANNEL_HITBOX_HEIGHT];
+}
 
-    result.sprite.x = lerp(animation->from.sprite.x, animation->to.sprite.x, factor);
-    result.sprite.y = lerp(animation->from.sprite.y, animation->to.sprite.y, factor);
-    result.sprite.z = lerp(animation->from.sprite.z, animation->to.sprite.z, factor);
-    result.sprite.rotation
-        = lerp(animation->from.sprite.rotation, animation->to.sprite.rotation, factor);
+static size_t animation_padded_count(size_t count) {
+    return (count + ANIMATION_LANES - 1) / ANIMATION_LANES * ANIMATION_LANES;
+}
 
-    result.sprite.color.r
-        = lerp(animation->from.sprite.color.r, animation->to.sprite.color.r, factor);
-    result.sprite.color.g
-        = lerp(animation->from.sprite.color.g, animation->to.sprite.color.g, factor);
-    result.sprite.color.b
-        = lerp(animation->from.sprite.color.b, animation->to.sprite.color.b, factor);
-    result.sprite.color.a
-        = lerp(animation->from.sprite.color.a, animation->to.sprite.color.a, factor);
+// Keeps every float array large enough for the kernel to read and write whole lanes
+static void animation_system_reserve(AnimationSystem* system, size_t count) {
+    size_t padded = animation_padded_count(count);
+    for (size_t c = 0; c < ANIMATION_CHANNEL_COUNT; c++) {
+        vec_ensure_capacity(&system->from[c], padded);
+        vec_ensure_capacity(&system->to[c], padded);
+        vec_ensure_capacity(&system->current[c], padded);
+    }
+    vec_ensure_capacity(&system->elapsed, padded);
+    vec_ensure_capacity(&system->duration, padded);
+    vec_ensure_capacity(&system->behaviour, count);
+    vec_ensure_capacity(&system->templates, count);
+    vec_ensure_capacity(&system->targets, count);
+    vec_ensure_capacity(&system->dense_slots, count);
+}
 
-    result.sprite.width = lerp(animation->from.sprite.width, animation->to.sprite.width, factor);
-    result.sprite.height = lerp(animation->from.sprite.height, animation->to.sprite.height, factor);
+static void animation_system_set_count(AnimationSystem* system, size_t count) {
+    for (size_t c = 0; c < ANIMATION_CHANNEL_COUNT; c++) {
+        system->from[c].size = system->to[c].size = system->current[c].size = count;
+    }
+    system->elapsed.size = system->duration.size = count;
+    system->behaviour.size = system->templates.size = system->targets.size = count;
+    system->dense_slots.size = count;
+    system->ui_animation_count = count;
+}
 
-    result.hitbox.x = lerp(animation->from.hitbox.x, animation->to.hitbox.x, factor);
-    result.hitbox.y = lerp(animation->from.hitbox.y, animation->to.hitbox.y, factor);
-    result.hitbox.width = lerp(animation->from.hitbox.width, animation->to.hitbox.width, factor);
-    result.hitbox.height = lerp(animation->from.hitbox.height, animation->to.hitbox.height, factor);
+static uint32_t animation_system_allocate_slot(AnimationSystem* system, uint32_t dense_index) {
+    uint32_t slot_index = system->free_slot;
+    AnimationSlot* slot;
+    if (slot_index != ANIMATION_NO_SLOT) {
+        slot = vec_get(&system->slots, slot_index);
+        system->free_slot = slot->next_free;
+    } else {
+        slot_index = (uint32_t)system->slots.size;
+        // generations start at 1, so a zeroed handle never refers to an animation
+        vec_push_back(&system->slots, &(AnimationSlot) { .generation = 1 });
+        slot = vec_get(&system->slots, slot_index);
+    }
+    slot->dense_index = dense_index;
+    slot->next_free = ANIMATION_NO_SLOT;
+    return slot_index;
+}
+
+static void animation_system_free_slot(AnimationSystem* system, uint32_t slot_index) {
+    AnimationSlot* slot = vec_get(&system->slots, slot_index);
+    slot->generation++;
+    slot->next_free = system->free_slot;
+    system->free_slot = slot_index;
+}
 
-    if (result.type == UI_CARD) {
-        result.meta.card.state = CARD_UI_STATE_NORMAL;
+// Dense index of a live handle, or -1
+static int64_t animation_system_resolve(AnimationSystem* system, AnimationHandle handle) {
+    if (handle.slot >= system->slots.size) {
+        return -1;
     }
+    AnimationSlot* slot = vec_get(&system->slots, handle.slot);
+    if (slot->generation != handle.generation || slot->next_free != ANIMATION_NO_SLOT) {
+        return -1;
+    }
+    return slot->dense_index;
+}
+
+AnimationHandle animation_system_push(
+    AnimationSystem* system,
+    const UIElementAnimation* animation
+) {
+    size_t index = system->ui_animation_count;
+    animation_system_reserve(system, index + 1);
+    animation_system_set_count(system, index + 1);
 
-    return result;
+    float from[ANIMATION_CHANNEL_COUNT];
+    float to[ANIMATION_CHANNEL_COUNT];
+    animation_channels_from_element(&animation->from, from);
+    animation_channels_from_element(&animation->to, to);
+    for (size_t c = 0; c < ANIMATION_CHANNEL_COUNT; c++) {
+        ((float*)system->from[c].data)[index] = from[c];
+        ((float*)system->to[c].data)[index] = to[c];
+        ((float*)system->current[c].data)[index] = from[c];
+    }
+
+    ((float*)system->elapsed.data)[index] = animation->elapsed;
+    ((float*)system->duration.data)[index] = animation->duration;
+    vec_set(&system->behaviour, index, &animation->behaviour);
+    vec_set(&system->templates, index, &animation->from);
+    vec_set(
+        &system->targets,
+        index,
+        &(AnimationTarget) {
+            .type = animation->to.type,
+            .location = animation->to.meta.card.selection_location,
+            .card_index = animation->to.meta.card.card_index,
+        }
+    );
+
+    uint32_t slot = animation_system_allocate_slot(system, (uint32_t)index);
+    ((uint32_t*)system->dense_slots.data)[index] = slot;
+
+    AnimationSlot* animation_slot = vec_get(&system->slots, slot);
+    system->last_pushed = (AnimationHandle) {
+        .slot = slot,
+        .generation = animation_slot->generation,
+    };
+    return system->last_pushed;
 }
 
-void animation_system_update(AnimationSystem* system, Controller* controller, float delta_time) {
-    controller->screen_needs_update |= system->ui_animations.size > 0;
-
-    for (size_t i = 0; i < system->ui_animations.size;) {
-        vec_get_as(UIElementAnimation, animation, &system->ui_animations, i);
-        animation.elapsed = clamp(animation.elapsed + delta_time, -INFINITY, animation.duration);
-        vec_set(&system->ui_animations, i, &animation);
-
-        if (animation.elapsed >= animation.duration) {
-            if (animation.behaviour == ANIMATION_DELETE_ON_FINISH) {
-                vec_delete(&system->ui_animations, i);
-            } else if (animation.behaviour == ANIMATION_STOP_ON_FINISH) {
-                i++;
-            } else {
-                animation.elapsed = 0.0f;
-                i++;
-            }
-        } else {
-            i++;
+void animation_system_clear(AnimationSystem* system) {
+    for (size_t i = 0; i < system->ui_animation_count; i++) {
+        animation_system_free_slot(system, ((uint32_t*)system->dense_slots.data)[i]);
+    }
+    animation_system_set_count(system, 0);
+}
+
+size_t animation_system_count(const AnimationSystem* system) {
+    return system->ui_animation_count;
+}
+
+bool animation_system_is_alive(AnimationSystem* system, AnimationHandle handle) {
+    return animation_system_resolve(system, handle) >= 0;
+}
+
+float animation_system_progress(AnimationSystem* system, AnimationHandle handle) {
+    int64_t index = animation_system_resolve(system, handle);
+    if (index < 0) {
+        return 1.0f;
+    }
+
+    float elapsed = ((float*)system->elapsed.data)[index];
+    float duration = ((float*)system->duration.data)[index];
+    return duration > 0.0f ? elapsed / duration : 1.0f;
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+typedef float f32x4 __attribute__((vector_size(16)));
+typedef int32_t i32x4 __attribute__((vector_size(16)));
+
+static inline f32x4 f32x4_load(const float* p) {
+    f32x4 v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline void f32x4_store(float* p, f32x4 v) { memcpy(p, &v, sizeof(v)); }
+
+// mask lanes are all ones or all zeros, as produced by vector comparisons
+static inline f32x4 f32x4_select(i32x4 mask, f32x4 a, f32x4 b) {
+    return (f32x4)((mask & (i32x4)a) | (~mask & (i32x4)b));
+}
+
+void animation_system_interpolate(AnimationSystem* system) {
+    size_t padded = animation_padded_count(system->ui_animation_count);
+    const float* elapsed = system->elapsed.data;
+    const float* duration = system->duration.data;
+
+    const f32x4 zero = { 0.0f, 0.0f, 0.0f, 0.0f };
+    const f32x4 half = { 0.5f, 0.5f, 0.5f, 0.5f };
+    const f32x4 one = { 1.0f, 1.0f, 1.0f, 1.0f };
+    const f32x4 four = { 4.0f, 4.0f, 4.0f, 4.0f };
+
+    for (size_t i = 0; i < padded; i += ANIMATION_LANES) {
+        f32x4 e = f32x4_load(elapsed + i);
+        f32x4 d = f32x4_load(duration + i);
+
+        // factor = elapsed / duration, or 1 for instant animations, clamped to [0, 1]
+        i32x4 has_duration = d > zero;
+        f32x4 t = e / f32x4_select(has_duration, d, one);
+        t = f32x4_select(has_duration, t, one);
+        t = f32x4_select(t < zero, zero, t);
+        t = f32x4_select(t > one, one, t);
+
+        // ease_in_out_cubic without powf: 4t^3 below one half, 1 - 4(1 - t)^3 above
+        f32x4 u = one - t;
+        f32x4 ease_in = four * t * t * t;
+        f32x4 ease_out = one - four * u * u * u;
+        f32x4 factor = f32x4_select(t < half, ease_in, ease_out);
+
+        for (size_t c = 0; c < ANIMATION_CHANNEL_COUNT; c++) {
+            f32x4 from = f32x4_load((float*)system->from[c].data + i);
+            f32x4 to = f32x4_load((float*)system->to[c].data + i);
+            f32x4_store((float*)system->current[c].data + i, from + (to - from) * factor);
         }
     }
 }
+#else
+void animation_system_interpolate(AnimationSystem* system) {
+    const float* elapsed = system->elapsed.data;
+    const float* duration = system->duration.data;
 
-bool animation_system_is_animated(AnimationSystem* anim_sys, UIElement* element) {
-    for (size_t i = 0; i < anim_sys->ui_animations.size; i++) {
-        vec_get_as(UIElementAnimation, anim, &anim_sys->ui_animations, i);
-        if (anim.to.type == element->type && element->type == UI_CARD) {
-            if (anim.to.meta.card.selection_location == element->meta.card.selection_location
-                && anim.to.meta.card.card_index == element->meta.card.card_index) {
-                return true;
-            }
+    for (size_t i = 0; i < system->ui_animation_count; i++) {
+        float t = (duration[i] > 0.0f) ? elapsed[i] / duration[i] : 1.0f;
+        float factor = ease_in_out_cubic(clamp(t, 0.0f, 1.0f));
+
+        for (size_t c = 0; c < ANIMATION_CHANNEL_COUNT; c++) {
+            float from = ((float*)system->from[c].data)[i];
+            float to = ((float*)system->to[c].data)[i];
+            ((float*)system->current[c].data)[i] = lerp(from, to, factor);
         }
+    }
+}
+#endif
+
+bool animation_system_get_frame(AnimationSystem* system, size_t index, UIElement* frame) {
+    if (((float*)system->elapsed.data)[index] <= 0.0f) {
+        return false;
+    }
+
+    float channels[ANIMATION_CHANNEL_COUNT];
+    for (size_t c = 0; c < ANIMATION_CHANNEL_COUNT; c++) {
+        channels[c] = ((float*)system->current[c].data)[index];
+    }
+
+    *frame = *(UIElement*)vec_get(&system->templates, index);
+    animation_channels_to_element(channels, frame);
+    if (frame->type == UI_CARD) {
+        frame->meta.card.state = CARD_UI_STATE_NORMAL;
+    }
+    return true;
+}
+
+// Moves animation src into dense index dst, src is left unused
+static void animation_system_move(AnimationSystem* system, size_t dst, size_t src) {
+    for (size_t c = 0; c < ANIMATION_CHANNEL_COUNT; c++) {
+        ((float*)system->from[c].data)[dst] = ((float*)system->from[c].data)[src];
+        ((float*)system->to[c].data)[dst] = ((float*)system->to[c].data)[src];
+        ((float*)system->current[c].data)[dst] = ((float*)system->current[c].data)[src];
+    }
+    ((float*)system->elapsed.data)[dst] = ((float*)system->elapsed.data)[src];
+    ((float*)system->duration.data)[dst] = ((float*)system->duration.data)[src];
+    vec_set(&system->behaviour, dst, vec_get(&system->behaviour, src));
+    vec_set(&system->templates, dst, vec_get(&system->templates, src));
+    vec_set(&system->targets, dst, vec_get(&system->targets, src));
+
+    uint32_t slot = ((uint32_t*)system->dense_slots.data)[src];
+    ((uint32_t*)system->dense_slots.data)[dst] = slot;
+    ((AnimationSlot*)vec_get(&system->slots, slot))->dense_index = (uint32_t)dst;
+}
 
-        if (anim.from.type == element->type && element->type == UI_CARD) {
-            if (anim.from.meta.card.selection_location == element->meta.card.selection_location
-                && anim.from.meta.card.card_index == element->meta.card.card_index) {
-                return true;
+// Removes in O(1) by moving the last animation into the hole
+static void animation_system_remove(AnimationSystem* system, size_t index) {
+    animation_system_free_slot(system, ((uint32_t*)system->dense_slots.data)[index]);
+
+    size_t last = system->ui_animation_count - 1;
+    if (index != last) {
+        animation_system_move(system, index, last);
+    }
+    animation_system_set_count(system, last);
+}
+
+void animation_system_cancel(AnimationSystem* system, AnimationHandle handle) {
+    int64_t index = animation_system_resolve(system, handle);
+    if (index >= 0) {
+        animation_system_remove(system, (size_t)index);
+    }
+}
+
+bool animation_system_retarget(
+    AnimationSystem* system,
+    AnimationHandle handle,
+    const UIElement* to,
+    float duration
+) {
+    int64_t index = animation_system_resolve(system, handle);
+    if (index < 0) {
+        return false;
+    }
+
+    float elapsed = ((float*)system->elapsed.data)[index];
+    float old_duration = ((float*)system->duration.data)[index];
+    float t = old_duration > 0.0f ? elapsed / old_duration : 1.0f;
+    float factor = ease_in_out_cubic(clamp(t, 0.0f, 1.0f));
+
+    float channels[ANIMATION_CHANNEL_COUNT];
+    animation_channels_from_element(to, channels);
+    for (size_t c = 0; c < ANIMATION_CHANNEL_COUNT; c++) {
+        float* from = (float*)system->from[c].data + index;
+        float* target = (float*)system->to[c].data + index;
+        *from = lerp(*from, *target, factor);
+        *target = channels[c];
+        ((float*)system->current[c].data)[index] = *from;
+    }
+
+    ((float*)system->elapsed.data)[index] = 0.0f;
+    ((float*)system->duration.data)[index] = duration;
+    vec_set(
+        &system->targets,
+        index,
+        &(AnimationTarget) {
+            .type = to->type,
+            .location = to->meta.card.selection_location,
+            .card_index = to->meta.card.card_index,
+        }
+    );
+    return true;
+}
+
+void animation_system_update(AnimationSystem* system, Controller* controller, float delta_time) {
+    // delayed animations don't need frames yet, the frame scheduler wakes up for them
+    controller->screen_needs_update |= animation_system_time_to_next_frame(system) == 0.0f;
+
+    float* elapsed = system->elapsed.data;
+    const float* duration = system->duration.data;
+
+    for (size_t i = 0; i < system->ui_animation_count;) {
+        float time = elapsed[i] + delta_time;
+        if (time > duration[i]) {
+            time = duration[i];
+        }
+        elapsed[i] = time;
+
+        UIElementAnimationEndBehaviour behaviour
+            = *(UIElementAnimationEndBehaviour*)vec_get(&system->behaviour, i);
+        if (time >= duration[i]) {
+            if (behaviour == ANIMATION_DELETE_ON_FINISH) {
+                // the last animation moves into i and is advanced next
+                animation_system_remove(system, i);
+                continue;
+            } else if (behaviour == ANIMATION_LOOP) {
+                elapsed[i] = 0.0f;
             }
         }
+        i++;
+    }
+}
+
+float animation_system_time_to_next_frame(const AnimationSystem* system) {
+    const float* elapsed = system->elapsed.data;
+
+    float next = INFINITY;
+    for (size_t i = 0; i < system->ui_animation_count; i++) {
+        if (elapsed[i] >= 0.0f) {
+            return 0.0f;
+        }
+        next = fminf(next, -elapsed[i]);
+    }
+    return next;
+}
+
+static void animation_system_mark(
+    AnimationSystem* anim_sys,
+    UIType type,
+    SelectionLocation location,
+    int card_index
+) {
+    if (type != UI_CARD) {
+        return;
+    }
+
+    if (location < ANIMATION_LOCATION_COUNT && card_index >= 0 && card_index < 32) {
+        anim_sys->animated[location] |= 1u << card_index;
+    }
+}
+
+void animation_system_mark_animated(AnimationSystem* anim_sys) {
+    memset(anim_sys->animated, 0, sizeof(anim_sys->animated));
+    for (size_t i = 0; i < anim_sys->ui_animation_count; i++) {
+        UIElement* from = vec_get(&anim_sys->templates, i);
+        AnimationTarget* to = vec_get(&anim_sys->targets, i);
+        animation_system_mark(
+            anim_sys,
+            from->type,
+            from->meta.card.selection_location,
+            from->meta.card.card_index
+        );
+        animation_system_mark(anim_sys, to->type, to->location, to->card_index);
+    }
+}
+
+bool animation_system_is_animated(AnimationSystem* anim_sys, UIElement* element) {
+    if (element->type != UI_CARD) {
+        return false;
+    }
+
+    SelectionLocation location = element->meta.card.selection_location;
+    int card_index = element->meta.card.card_index;
+    if (location >= ANIMATION_LOCATION_COUNT || card_index < 0 || card_index >= 32) {
+        return false;
     }
-    return false;
+    return (anim_sys->animated[location] >> card_index) & 1u;
 }
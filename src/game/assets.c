@@ -1,23 +1,40 @@
 #include "game/assets.h"
 
-#include "rendering/image.h"
+#include "core/log.h"
+
 #include "rendering/shader.h"
 #include "rendering/texture.h"
+#include "rendering/uniform_buffer.h"
 
 #include "game/constants.h"
 #include "game/ui_sprites.h"
 
+static const char* MAIN_SHADER_UNIFORM_NAMES[MAIN_SHADER_UNIFORM_COUNT] = {
+    [MAIN_SHADER_SPRITESHEET] = "spritesheet",
+    [MAIN_SHADER_GLYPH_ATLAS] = "glyph_atlas",
+};
+
 Assets assets_init() {
     Assets assets;
 
-    Image spritesheet
-        = image_load_from_memory((const uint8_t*)MAIN_SPRITESHEET, MAIN_SPRITESHEET_SIZE, 4);
-    assets.spritesheet_texture = texture_init(&spritesheet);
-    image_free(&spritesheet);
+    // both are decoded at build time, so startup is a straight upload
+    assets.spritesheet_texture
+        = texture_init_from_blob((const uint8_t*)MAIN_SPRITESHEET, MAIN_SPRITESHEET_SIZE);
+    assets.glyph_atlas_texture
+        = texture_init_from_blob((const uint8_t*)GLYPH_SDF_ATLAS, GLYPH_SDF_ATLAS_SIZE);
 
-    assets.main_shader = shader_init(MAIN_VERTEX_SHADER_SOURCE, MAIN_FRAGMENT_SHADER_SOURCE);
+    assets.main_shader = shader_init(
+        MAIN_VERTEX_SHADER_SOURCE,
+        MAIN_FRAGMENT_SHADER_SOURCE,
+        MAIN_SHADER_UNIFORM_NAMES,
+        MAIN_SHADER_UNIFORM_COUNT
+    );
 
-    if (assets.main_shader == 0) {
+    if (assets.main_shader.program == 0) {
+        exit(EXIT_FAILURE);
+    }
+    if (!shader_bind_uniform_block(&assets.main_shader, "Camera", UNIFORM_BINDING_CAMERA)) {
+        log_error("The main shader has no Camera uniform block");
         exit(EXIT_FAILURE);
     }
 
@@ -26,5 +43,6 @@ Assets assets_init() {
 
 void assets_free(Assets* assets) {
     texture_free(&assets->spritesheet_texture);
+    texture_free(&assets->glyph_atlas_texture);
     shader_free(&assets->main_shader);
 }
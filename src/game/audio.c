@@ -0,0 +1,263 @@
+#include <string.h>
+
+#include "game/audio.h"
+
+#include "core/log.h"
+#include "game/constants.h"
+#include "game/profiler.h"
+#include "utils.h"
+
+void audio_init(Audio* audio) {
+    memset(audio, 0, sizeof(Audio));
+    audio_queue_init(&audio->queue);
+}
+
+// Frees the voices and PCM of the first count sounds
+static void audio_free_sounds(Audio* audio, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        SoundBankEntry* entry = &audio->sounds[i];
+        for (size_t v = 0; v < AUDIO_VOICES_PER_SOUND; v++) {
+            ma_sound_uninit(&entry->voices[v].sound);
+            ma_audio_buffer_uninit(&entry->voices[v].buffer);
+        }
+        ma_free(entry->frames, NULL);
+        entry->frames = NULL;
+    }
+}
+
+void audio_free(Audio* audio) {
+    if (!audio->started) {
+        return;
+    }
+    // the device goes first, so the callback no longer touches the voices
+    ma_device_uninit(&audio->device);
+    audio_free_sounds(audio, SOUND_COUNT);
+    ma_engine_uninit(&audio->engine);
+    audio->started = false;
+}
+
+// Decodes a sound and creates its voices
+static bool audio_load_sound(Audio* audio, SoundBankEntry* entry, const void* data, size_t size) {
+    ma_uint32 channels = ma_engine_get_channels(&audio->engine);
+    ma_decoder_config decoder_config = ma_decoder_config_init(
+        ma_format_f32,
+        channels,
+        ma_engine_get_sample_rate(&audio->engine)
+    );
+
+    ma_uint64 frame_count;
+    void* frames;
+    ma_result result = ma_decode_memory(data, size, &decoder_config, &frame_count, &frames);
+    if (result != MA_SUCCESS) {
+        log_error("Failed to decode sound: %s", ma_result_description(result));
+        return false;
+    }
+    entry->frames = frames;
+    entry->frame_count = frame_count;
+
+    // every voice reads the same frames, the buffers don't copy them
+    ma_audio_buffer_config buffer_config
+        = ma_audio_buffer_config_init(ma_format_f32, channels, frame_count, frames, NULL);
+    for (size_t v = 0; v < AUDIO_VOICES_PER_SOUND; v++) {
+        AudioVoice* voice = &entry->voices[v];
+        result = ma_audio_buffer_init(&buffer_config, &voice->buffer);
+        if (result == MA_SUCCESS) {
+            result = ma_sound_init_from_data_source(
+                &audio->engine,
+                &voice->buffer,
+                0,
+                NULL,
+                &voice->sound
+            );
+            if (result != MA_SUCCESS) {
+                ma_audio_buffer_uninit(&voice->buffer);
+            }
+        }
+        if (result != MA_SUCCESS) {
+            log_error("Failed to initialize voice: %s", ma_result_description(result));
+            for (size_t i = 0; i < v; i++) {
+                ma_sound_uninit(&entry->voices[i].sound);
+                ma_audio_buffer_uninit(&entry->voices[i].buffer);
+            }
+            ma_free(entry->frames, NULL);
+            entry->frames = NULL;
+            return false;
+        }
+    }
+    return true;
+}
+
+// A voice that finished, or the one started the longest time ago
+static AudioVoice* audio_find_voice(SoundBankEntry* entry) {
+    AudioVoice* oldest = &entry->voices[0];
+    for (size_t v = 0; v < AUDIO_VOICES_PER_SOUND; v++) {
+        AudioVoice* voice = &entry->voices[v];
+        if (!ma_sound_is_playing(&voice->sound)) {
+            return voice;
+        }
+        if (voice->started < oldest->started) {
+            oldest = voice;
+        }
+    }
+    return oldest;
+}
+
+// Runs on the audio thread
+static void audio_apply_command(Audio* audio, const AudioCommand* command, ma_uint64 start_frame) {
+    SoundBankEntry* entry = &audio->sounds[command->sound];
+    if (command->type == AUDIO_COMMAND_PLAY) {
+        AudioVoice* voice = audio_find_voice(entry);
+        ma_sound_stop(&voice->sound);
+        ma_sound_seek_to_pcm_frame(&voice->sound, 0);
+        ma_sound_set_pan(&voice->sound, command->pan);
+        ma_sound_set_pitch(&voice->sound, command->pitch);
+        ma_sound_set_start_time_in_pcm_frames(&voice->sound, start_frame);
+        ma_sound_start(&voice->sound);
+        voice->started = ++audio->play_count;
+    } else if (command->type == AUDIO_COMMAND_STOP) {
+        for (size_t v = 0; v < AUDIO_VOICES_PER_SOUND; v++) {
+            ma_sound_stop(&entry->voices[v].sound);
+        }
+    }
+}
+
+/** Frame of the engine clock a command queued at queued_micros starts on.
+ * Every command is delayed by one period from when it was queued, instead of landing on the
+ * start of the next period, so the spacing between triggers survives the device's buffering.
+ * Stops still take effect at the start of the period.
+ */
+static ma_uint64 audio_command_start_frame(
+    Audio* audio,
+    const AudioCommand* command,
+    uint64_t now_micros,
+    ma_uint32 frame_count
+) {
+    ma_uint64 period_start = ma_engine_get_time_in_pcm_frames(&audio->engine);
+    uint64_t age_micros =
+        now_micros > command->queued_micros ? now_micros - command->queued_micros : 0;
+    uint64_t age_frames = age_micros * ma_engine_get_sample_rate(&audio->engine) / 1000000;
+    // commands older than a period come from a stalled mixer, they start right away
+    return age_frames < frame_count ? period_start + frame_count - age_frames : period_start;
+}
+
+// Applies the queued commands, then mixes the period
+static void audio_data_callback(
+    ma_device* device,
+    void* output,
+    const void* input,
+    ma_uint32 frame_count
+) {
+    (void)input;
+    Audio* audio = device->pUserData;
+
+    uint64_t now_micros = time_micros();
+    AudioCommand command;
+    while (audio_queue_pop(&audio->queue, &command)) {
+        ma_uint64 start_frame =
+            audio_command_start_frame(audio, &command, now_micros, frame_count);
+        audio_apply_command(audio, &command, start_frame);
+    }
+    ma_engine_read_pcm_frames(&audio->engine, output, frame_count, NULL);
+}
+
+bool audio_start(Audio* audio) {
+    if (audio->started || audio->failed) {
+        return audio->started;
+    }
+
+    // the device is owned here instead of by the engine, so its callback can drain the queue
+    ma_device_config device_config = ma_device_config_init(ma_device_type_playback);
+    device_config.playback.format = ma_format_f32;
+    device_config.dataCallback = audio_data_callback;
+    device_config.pUserData = audio;
+    ma_result result = ma_device_init(NULL, &device_config, &audio->device);
+    if (result != MA_SUCCESS) {
+        log_error("Failed to open audio device: %s", ma_result_description(result));
+        audio->failed = true;
+        return false;
+    }
+
+    ma_engine_config engine_config = ma_engine_config_init();
+    engine_config.pDevice = &audio->device;
+    result = ma_engine_init(&engine_config, &audio->engine);
+    if (result != MA_SUCCESS) {
+        log_error("Failed to initialize audio engine: %s", ma_result_description(result));
+        ma_device_uninit(&audio->device);
+        audio->failed = true;
+        return false;
+    }
+
+    const void* sound_data[SOUND_COUNT] = {
+        [SOUND_CARD_MOVE] = CARD_MOVE_SOUND,
+    };
+    size_t sound_sizes[SOUND_COUNT] = {
+        [SOUND_CARD_MOVE] = CARD_MOVE_SOUND_SIZE,
+    };
+
+    // decoded on the game thread, the bank is a single short clip (668 frames of 16 bit mono)
+    // and converting it costs far less than opening the device above. A larger bank should
+    // be decoded on a worker instead, sound_bank in the startup report shows the cost.
+    profiler_startup_begin(PROFILER_STARTUP_SOUND_BANK);
+    for (size_t i = 0; i < SOUND_COUNT; i++) {
+        if (!audio_load_sound(audio, &audio->sounds[i], sound_data[i], sound_sizes[i])) {
+            profiler_startup_end(PROFILER_STARTUP_SOUND_BANK);
+            ma_device_uninit(&audio->device);
+            audio_free_sounds(audio, i);
+            ma_engine_uninit(&audio->engine);
+            audio->failed = true;
+            return false;
+        }
+    }
+    profiler_startup_end(PROFILER_STARTUP_SOUND_BANK);
+
+    // started last, the callback must never see a half initialized sound bank
+    result = ma_device_start(&audio->device);
+    if (result != MA_SUCCESS) {
+        log_error("Failed to start audio device: %s", ma_result_description(result));
+        ma_device_uninit(&audio->device);
+        audio_free_sounds(audio, SOUND_COUNT);
+        ma_engine_uninit(&audio->engine);
+        audio->failed = true;
+        return false;
+    }
+
+    audio->started = true;
+    return true;
+}
+
+static void audio_push(Audio* audio, const AudioCommand* command) {
+#ifndef __EMSCRIPTEN__
+    if (!audio_start(audio)) {
+        return;
+    }
+    AudioCommand queued = *command;
+    queued.queued_micros = time_micros();
+    // a full ring means the mixer stalled, dropping the sound is better than blocking
+    audio_queue_push(&audio->queue, &queued);
+#else
+    (void)audio;
+    (void)command;
+#endif
+}
+
+void audio_play(Audio* audio, SoundId sound, float pan, float pitch) {
+    audio_push(
+        audio,
+        &(AudioCommand) {
+            .type = AUDIO_COMMAND_PLAY,
+            .sound = sound,
+            .pan = pan,
+            .pitch = pitch,
+        }
+    );
+}
+
+void audio_stop(Audio* audio, SoundId sound) {
+    audio_push(
+        audio,
+        &(AudioCommand) {
+            .type = AUDIO_COMMAND_STOP,
+            .sound = sound,
+        }
+    );
+}
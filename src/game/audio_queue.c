@@ -0,0 +1,37 @@
+#include <string.h>
+
+#include "game/audio_queue.h"
+
+void audio_queue_init(AudioQueue* queue) {
+    memset(queue->commands, 0, sizeof(queue->commands));
+    atomic_init(&queue->write_index, 0);
+    atomic_init(&queue->read_index, 0);
+    queue->dropped = 0;
+}
+
+bool audio_queue_push(AudioQueue* queue, const AudioCommand* command) {
+    uint32_t write = atomic_load_explicit(&queue->write_index, memory_order_relaxed);
+    uint32_t read = atomic_load_explicit(&queue->read_index, memory_order_acquire);
+    if (write - read == AUDIO_QUEUE_CAPACITY) {
+        queue->dropped++;
+        return false;
+    }
+
+    queue->commands[write & (AUDIO_QUEUE_CAPACITY - 1)] = *command;
+    // publishes the command before the consumer can see the new index
+    atomic_store_explicit(&queue->write_index, write + 1, memory_order_release);
+    return true;
+}
+
+bool audio_queue_pop(AudioQueue* queue, AudioCommand* command) {
+    uint32_t read = atomic_load_explicit(&queue->read_index, memory_order_relaxed);
+    uint32_t write = atomic_load_explicit(&queue->write_index, memory_order_acquire);
+    if (read == write) {
+        return false;
+    }
+
+    *command = queue->commands[read & (AUDIO_QUEUE_CAPACITY - 1)];
+    // frees the slot only after it was copied out
+    atomic_store_explicit(&queue->read_index, read + 1, memory_order_release);
+    return true;
+}
@@ -1,11 +1,16 @@
+#include <string.h>
+
 #include "game/controller.h"
 
 #include "core/aalloc.h"
 #include "core/vector.h"
 
 #include "game/animation.h"
+#include "game/audio.h"
 #include "game/game.h"
 #include "game/input.h"
+#include "game/profiler.h"
+#include "game/timeline.h"
 #include "game/ui_element.h"
 #include "game/ui_state.h"
 #include "platform/window.h"
@@ -17,69 +22,61 @@
 
 #include "utils.h"
 
-static void controller_play_card_move_sound(World* world) {
+// Stereo width of the card move sound, 1 would pan fully to the side at the window edges
+#define CARD_MOVE_PAN 0.6f
+// Random pitch variation, so repeated moves don't sound identical
+#define CARD_MOVE_PITCH_VARIATION 0.08f
+
+// Plays the card move sound panned towards x, where the card lands
+static void controller_play_card_move_sound(World* world, float x) {
     if (world->sound_enabled) {
-#ifndef __EMSCRIPTEN__
-        ma_sound_stop(&world->card_move_sound);
-        ma_sound_start(&world->card_move_sound);
-#endif
+        float pan = clamp(x / VIRTUAL_WIDTH * 2.0f - 1.0f, -1.0f, 1.0f) * CARD_MOVE_PAN;
+        float pitch = 1.0f + (random_uniform() * 2.0f - 1.0f) * CARD_MOVE_PITCH_VARIATION;
+        audio_play(&world->audio, SOUND_CARD_MOVE, pan, pitch);
     }
 }
 
-static void controller_animate_game_over(World* world) {
-    AnimationSystem* animation_system = &world->animation_system;
-
-    // Don't add too many animations if there are already animations running
-    if (world->animation_system.ui_animations.size > 2) {
-        return;
-    } else if (world->animation_system.ui_animations.size > 0) {
-        float progress_threshold = 0.5;
-        vec_get_as(
-            UIElementAnimation,
-            anim,
-            &world->animation_system.ui_animations,
-            world->animation_system.ui_animations.size - 1
-        );
-        if (anim.elapsed / anim.duration < progress_threshold) {
-            return;
-        }
-    }
-
-    // nothing left in foundation
-    bool found = false;
-    for (int i = 0; i < 4; i++) {
-        if (world->game.freecell.foundation[0] != NONE) {
-            found = true;
-        }
-    }
-    if (!found)
-        return;
+// Seconds between two cards flying off the foundation
+#define GAME_OVER_INTERVAL 2.0
+// Seconds between two autocomplete moves
+#define AUTOCOMPLETE_INTERVAL 0.175
+#define AUTOCOMPLETE_DURATION 0.35f
+// Seconds between two cards of the deal
+#define DEAL_INTERVAL 0.01
+
+static void controller_clear_animations(World* world) {
+    animation_system_clear(&world->animation_system);
+    timeline_clear(&world->timeline);
+    world->controller.game_over_scheduled = false;
+    world->controller.autocomplete_scheduled = false;
+}
 
-    Freecell* freecell = &world->game.freecell;
+static void controller_animate_game_over(World* world, uint32_t argument) {
+    (void)argument;
+    AnimationSystem* animation_system = &world->animation_system;
+    Card* foundation = world->controller.game_over_foundation;
 
     // find largest ranked foundation.
-    int idx = 0;
+    int idx = -1;
     int largest_rank = -1;
     for (int i = 3; i >= 0; i--) {
-        if (freecell->foundation[i] != NONE && get_rank(freecell->foundation[i]) > largest_rank) {
-            largest_rank = get_rank(freecell->foundation[i]);
+        if (foundation[i] != NONE && get_rank(foundation[i]) > largest_rank) {
+            largest_rank = get_rank(foundation[i]);
             idx = i;
         }
     }
 
-    UIElement foundation_item;
-    if (ui_find_in_layout(
-            &world->ui_elements,
-            FOUNDATION_SPADES + idx,
-            0,
-            &foundation_item,
-            NULL
-        )) {
-        Card card = world->game.freecell.foundation[idx];
-        Rank rank = get_rank(card);
-        Card new_card = (rank == ACE) ? NONE : get_card(rank - 1, get_suit(card));
-        world->game.freecell.foundation[idx] = new_card;
+    // nothing left in foundation
+    if (idx < 0)
+        return;
 
+    Card card = foundation[idx];
+    Rank rank = get_rank(card);
+    Card new_card = (rank == ACE) ? NONE : get_card(rank - 1, get_suit(card));
+    foundation[idx] = new_card;
+
+    UIElement foundation_item;
+    if (ui_find_in_layout(world, FOUNDATION_SPADES + idx, 0, &foundation_item, NULL)) {
         UIElement* elem = &foundation_item;
         float duration = 4.0f;
 
@@ -104,7 +101,7 @@ static void controller_animate_game_over(World* world) {
             };
 
             static_animation.to = static_animation.from;
-            vec_push_back(&animation_system->ui_animations, &static_animation);
+            animation_system_push(animation_system, &static_animation);
         }
 
         // actual animation
@@ -154,14 +151,40 @@ static void controller_animate_game_over(World* world) {
                 },
             };
 
-        vec_push_back(&animation_system->ui_animations, &animation);
+        animation_system_push(animation_system, &animation);
+    }
+}
+
+static void controller_schedule_game_over(World* world) {
+    Freecell* freecell = &world->game.freecell;
+
+    // one card leaves the foundation per callback
+    size_t card_count = 0;
+    for (int i = 0; i < 4; i++) {
+        if (freecell->foundation[i] != NONE) {
+            card_count += get_rank(freecell->foundation[i]) - ACE + 1;
+        }
+    }
+
+    for (size_t i = 0; i < card_count; i++) {
+        timeline_add_callback(
+            &world->timeline,
+            i * GAME_OVER_INTERVAL,
+            controller_animate_game_over,
+            0
+        );
     }
+    memcpy(
+        world->controller.game_over_foundation,
+        freecell->foundation,
+        sizeof(freecell->foundation)
+    );
+    world->controller.game_over_scheduled = true;
 }
 
 static void controller_animate_new_game(World* world) {
     // Before new game ui_elements
     AnimationSystem* animation_system = &world->animation_system;
-    animation_system->ui_animations.size = 0; // clear all other animations.
 
     for (int i = 0; i < world->ui_elements.size; i++) {
         vec_get_as(UIElement, to, &world->ui_elements, i);
@@ -170,8 +193,8 @@ static void controller_animate_new_game(World* world) {
         to.sprite.y = VIRTUAL_HEIGHT / 2.0;
 
         if (to.type == UI_CARD && to.meta.card.card != NONE) {
-            vec_push_back(
-                &animation_system->ui_animations,
+            animation_system_push(
+                animation_system,
                 &(UIElementAnimation) {
                     .from = from,
                     .to = to,
@@ -185,7 +208,8 @@ static void controller_animate_new_game(World* world) {
 
     render_world(world);
 
-    // After new game ui_elements
+    // After new game ui_elements, dealt one after another once the old cards are gone
+    Vector deal = vec_init(sizeof(UIElementAnimation));
     for (int i = 0; i < world->ui_elements.size; i++) {
         vec_get_as(UIElement, to, &world->ui_elements, i);
         UIElement from = to;
@@ -194,17 +218,19 @@ static void controller_animate_new_game(World* world) {
 
         if (to.type == UI_CARD) {
             vec_push_back(
-                &animation_system->ui_animations,
+                &deal,
                 &(UIElementAnimation) {
                     .from = from,
                     .to = to,
-                    .elapsed = -0.3f,
+                    .elapsed = 0.0f,
                     .duration = 0.3f,
                     .behaviour = ANIMATION_DELETE_ON_FINISH,
                 }
             );
         }
     }
+    timeline_add_stagger(animation_system, 0.3, DEAL_INTERVAL, deal.data, deal.size);
+    vec_free(&deal);
 }
 
 static MoveResult controller_animated_move(World* world, Move move, float duration) {
@@ -220,14 +246,16 @@ static MoveResult controller_animated_move(World* world, Move move, float durati
         = freecell_get_index_from_size(&world->game.freecell, move.from, move.size);
 
     UIElement from, to;
-    if (ui_find_in_layout(&world->ui_elements, move.from, from_move_index, &from, NULL)) {
+    float sound_x = VIRTUAL_WIDTH / 2.0f;
+    if (ui_find_in_layout(world, move.from, from_move_index, &from, NULL)) {
         // We don't need to support cascade animation for stacks
         uint8_t to_move_index = 0;
-        if (ui_find_in_layout(&world->ui_elements, move.to, 0, &to, NULL)) {
+        if (ui_find_in_layout(world, move.to, 0, &to, NULL)) {
             to.sprite.color.a = from.sprite.color.a;
+            sound_x = to.sprite.x;
 
-            vec_push_back(
-                &animation_system->ui_animations,
+            animation_system_push(
+                animation_system,
                 &(UIElementAnimation) {
                     .from = from,
                     .to = to,
@@ -240,33 +268,18 @@ static MoveResult controller_animated_move(World* world, Move move, float durati
     }
 
     game_move(&world->game, move);
-    controller_play_card_move_sound(world);
+    controller_play_card_move_sound(world, sound_x);
     return result;
 }
 
-static void controller_autocomplete_game(World* world) {
+static void controller_autocomplete_game(World* world, uint32_t argument) {
+    (void)argument;
     if (freecell_game_over(&world->game.freecell)
         || !freecell_is_trivially_solved(&world->game.freecell)) {
+        world->controller.autocomplete_scheduled = false;
         return;
     }
 
-    // better UX if i allow more than one animation
-    // if the earlier is beyond threshold
-    if (world->animation_system.ui_animations.size > 2) {
-        return;
-    } else if (world->animation_system.ui_animations.size > 0) {
-        float progress_threshold = 0.5;
-        vec_get_as(
-            UIElementAnimation,
-            anim,
-            &world->animation_system.ui_animations,
-            world->animation_system.ui_animations.size - 1
-        );
-        if (anim.elapsed / anim.duration < progress_threshold) {
-            return;
-        }
-    }
-
     // find the smallest card in the cascade (or reserve)
     Freecell* freecell = &world->game.freecell;
 
@@ -314,25 +327,42 @@ static void controller_autocomplete_game(World* world) {
         .size = 1,
     };
 
-    controller_animated_move(world, move, 0.35f);
+    controller_animated_move(world, move, AUTOCOMPLETE_DURATION);
+
+    // the next move starts halfway through this one
+    timeline_add_callback(&world->timeline, AUTOCOMPLETE_INTERVAL, controller_autocomplete_game, 0);
 }
 
 void controller_update(World* world, double dt) {
     world->controller.screen_needs_update = false;
+    profiler_begin(&world->profiler, PROFILER_PHASE_INPUT);
     controller_handle_inputs(world);
+    profiler_end(&world->profiler, PROFILER_PHASE_INPUT);
+
+    controller_update_drag(world);
+    controller_step(world, dt);
+    render_world(world);
+}
 
+void controller_step(World* world, double dt) {
     Controller* controller = &world->controller;
     if (!freecell_game_over(&world->game.freecell)) {
         world->game.clock += dt;
     }
 
-    controller_update_drag(world);
     animation_system_update(&world->animation_system, controller, dt);
-    render_world(world);
-    controller_autocomplete_game(world);
+    // callbacks run after the update so that the animations they start keep the overshoot
+    timeline_update(&world->timeline, world, dt);
 
-    if (freecell_game_over(&world->game.freecell)) {
-        controller_animate_game_over(world);
+    // the sequences drive themselves once started
+    Freecell* freecell = &world->game.freecell;
+    if (freecell_game_over(freecell)) {
+        if (!controller->game_over_scheduled) {
+            controller_schedule_game_over(world);
+        }
+    } else if (!controller->autocomplete_scheduled && freecell_is_trivially_solved(freecell)) {
+        controller->autocomplete_scheduled = true;
+        timeline_add_callback(&world->timeline, 0.0, controller_autocomplete_game, 0);
     }
 }
 
@@ -341,7 +371,7 @@ void controller_click(World* world) {
 
     UIElement ui_element;
     size_t index;
-    if (ui_get_topmost_hit(&world->ui_elements, mouse, &ui_element, &index)) {
+    if (ui_get_topmost_hit(world, &world->ui_elements, mouse, &ui_element, &index)) {
         if (ui_element.type == UI_BUTTON) {
             // handle button click
             const char* id = aptr(ui_element.meta.button.id);
@@ -363,7 +393,7 @@ void controller_start_drag(World* world) {
     vec2s mouse = world->controller.mouse;
 
     UIElement ui_element;
-    if (ui_get_topmost_hit(&world->ui_elements, mouse, &ui_element, NULL)) {
+    if (ui_get_topmost_hit(world, &world->ui_elements, mouse, &ui_element, NULL)) {
         if (!ui_is_element_draggable(world, &ui_element) || ui_element.type != UI_CARD) {
             return;
         }
@@ -379,7 +409,7 @@ void controller_start_drag(World* world) {
 
 void controller_update_drag(World* world) {
     if (freecell_game_over(&world->game.freecell)
-        || world->animation_system.ui_animations.size > 0) {
+        || animation_system_count(&world->animation_system) > 0) {
         world->controller.drag_state.dragging = false;
     }
 }
@@ -391,7 +421,7 @@ void controller_end_drag(World* world) {
     Vector* ui_elements = &world->ui_elements;
     UIElement dest;
     if (drag_state->dragging
-        && ui_get_topmost_hit(ui_elements, world->controller.mouse, &dest, NULL)
+        && ui_get_topmost_hit(world, ui_elements, world->controller.mouse, &dest, NULL)
         && dest.type == UI_CARD) {
         controller_handle_card_drop(
             &dest,
@@ -446,7 +476,7 @@ bool controller_handle_card_drop(
     );
 
     if (result == MOVE_SUCCESS) {
-        controller_play_card_move_sound(world);
+        controller_play_card_move_sound(world, dest->sprite.x);
     }
 
     return result == MOVE_SUCCESS;
@@ -460,7 +490,7 @@ void controller_smart_move(World* world) {
 
     UIElement topmost;
     size_t index;
-    if (ui_get_topmost_hit(&world->ui_elements, mouse, &topmost, &index)) {
+    if (ui_get_topmost_hit(world, &world->ui_elements, mouse, &topmost, &index)) {
         if (animation_system_is_animated(animation_system, &topmost)) {
             // if we are clicking on an animated element, do nothing
             return;
@@ -561,21 +591,21 @@ void controller_undo(World* world) {
     }
 
     if (game_undo(&world->game) == MOVE_SUCCESS) {
-        world->animation_system.ui_animations.size = 0;
-        controller_play_card_move_sound(world);
+        controller_clear_animations(world);
+        controller_play_card_move_sound(world, VIRTUAL_WIDTH / 2.0f);
     }
 }
 
 void controller_new_game(World* world) {
     Controller* controller = &world->controller;
-    world->animation_system.ui_animations.size = 0;
+    controller_clear_animations(world);
     game_new(&world->game);
     controller_animate_new_game(world);
 }
 
 void controller_new_game_with_seed(World* world, uint32_t seed) {
     Controller* controller = &world->controller;
-    world->animation_system.ui_animations.size = 0;
+    controller_clear_animations(world);
     game_new_from_seed(&world->game, seed);
     controller_animate_new_game(world);
 }
@@ -590,6 +620,14 @@ void controller_toggle_fullscreen(World* world) {
 
 void controller_toggle_help(World* world) { world->show_help = !world->show_help; }
 
+void controller_toggle_profiler(World* world) {
+    world->profiler.show_overlay = !world->profiler.show_overlay;
+}
+
+void controller_dump_trace(World* world) {
+    profiler_dump_trace(&world->profiler, "freecell_trace.json");
+}
+
 static void controller_autocompleteable_game(World* world) {
     (void)world;
 #ifdef FREECELL_DEBUG
@@ -629,16 +667,12 @@ static void controller_autocompleteable_game(World* world) {
     world->game.history.size = 0;
     world->game.move_count = 0;
     world->game.clock = 0.0;
-    world->animation_system.ui_animations.size = 0;
+    controller_clear_animations(world);
 #endif
 }
 
-static void controller_fill_cascades(World* world) {
-    (void)world;
-#ifdef FREECELL_DEBUG
-    Controller* controller = &world->controller;
-
-    // make all cascades full for debugging view
+void controller_fill_cascades(World* world) {
+    // make all cascades full, the largest layout there is
     world->game.seed = 0;
     Freecell* freecell = &world->game.freecell;
 
@@ -658,8 +692,7 @@ static void controller_fill_cascades(World* world) {
     world->game.history.size = 0;
     world->game.move_count = 0;
     world->game.clock = 0.0;
-    world->animation_system.ui_animations.size = 0;
-#endif
+    controller_clear_animations(world);
 }
 
 void controller_handle_input(InputAction ia) {
@@ -689,10 +722,16 @@ void controller_handle_input(InputAction ia) {
         controller_toggle_fullscreen(ia.world);
     } else if (ia.type == INPUT_ACTION_TOGGLE_HELP) {
         controller_toggle_help(ia.world);
+    } else if (ia.type == INPUT_ACTION_TOGGLE_PROFILER) {
+        controller_toggle_profiler(ia.world);
+    } else if (ia.type == INPUT_ACTION_DUMP_TRACE) {
+        controller_dump_trace(ia.world);
     } else if (ia.type == INPUT_ACTION_AUTOCOMPLETEABLE_GAME) {
         controller_autocompleteable_game(ia.world);
     } else if (ia.type == INPUT_ACTION_FILL_CASCADES) {
+#ifdef FREECELL_DEBUG
         controller_fill_cascades(ia.world);
+#endif
     }
 }
 
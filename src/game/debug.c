@@ -6,26 +6,21 @@
 #include "rendering/mesh.h"
 #include <string.h>
 
+#include "game/render_system.h"
 #include "game/ui_element.h"
-#include "rendering/renderer.h"
+#include "rendering/render_queue.h"
 
 void debug_render_mouse(World* world) {
-    Mesh mesh = mesh_init();
-    GPUMesh gpu_mesh = gpu_mesh_init();
-
+    RenderQueue* queue = &world->render_queue;
     mesh_push_circle(
-        &mesh,
+        render_queue_mesh(queue),
         (Circle) { .x = world->controller.mouse.x,
                    .y = world->controller.mouse.y,
                    .radius = 5.0f,
                    12,
                    (Color) { 1.0f, 0.0f, 0.0f, 1.0f } }
     );
-    gpu_mesh_upload(&gpu_mesh, &mesh);
-    renderer_draw_mesh(&gpu_mesh, GL_TRIANGLES);
-
-    gpu_mesh_free(&gpu_mesh);
-    mesh_free(&mesh);
+    render_queue_submit(queue, render_state_main(world, RENDER_LAYER_DEBUG, GL_TRIANGLES));
 }
 
 static void mesh_push_hitbox(Mesh* mesh, Rect hitbox, Color color) {
@@ -37,29 +32,14 @@ static void mesh_push_hitbox(Mesh* mesh, Rect hitbox, Color color) {
     float halfW = hitbox.width / 2.f;
     float halfH = hitbox.height / 2.f;
 
-    vertices[0].x = x + halfW;
-    vertices[0].y = y - halfH;
-    vertices[0].z = 0.0f;
-
-    vertices[1].x = x + halfW;
-    vertices[1].y = y + halfH;
-    vertices[1].z = 0.0f;
-
-    vertices[2].x = x - halfW;
-    vertices[2].y = y + halfH;
-    vertices[2].z = 0.0f;
-
-    vertices[3].x = x - halfW;
-    vertices[3].y = y - halfH;
-    vertices[3].z = 0.0f;
+    vertex_set_position(&vertices[0], x + halfW, y - halfH, 0.0f);
+    vertex_set_position(&vertices[1], x + halfW, y + halfH, 0.0f);
+    vertex_set_position(&vertices[2], x - halfW, y + halfH, 0.0f);
+    vertex_set_position(&vertices[3], x - halfW, y - halfH, 0.0f);
 
     for (size_t i = 0; i < sizeof(vertices) / sizeof(vertices[0]); i++) {
-        vertices[i].r = color.r;
-        vertices[i].g = color.g;
-        vertices[i].b = color.b;
-        vertices[i].a = color.a;
-        vertices[i].u = 0.2f;
-        vertices[i].v = 0.0f;
+        vertex_set_color(&vertices[i], color);
+        vertex_set_tex_coords(&vertices[i], 0.2f, 0.0f);
     }
 
     uint32_t base_index = (uint32_t)mesh->vertices.size;
@@ -78,26 +58,22 @@ static void mesh_push_hitbox(Mesh* mesh, Rect hitbox, Color color) {
 }
 
 void debug_render_hit_hitbox(World* world) {
-    Mesh mesh = mesh_init();
-    GPUMesh gpu_mesh = gpu_mesh_init();
+    RenderQueue* queue = &world->render_queue;
+    Mesh* mesh = render_queue_mesh(queue);
 
     vec2s mouse = world->controller.mouse;
 
     for (int i = 0; i < world->ui_elements.size; i++) {
         vec_get_as(UIElement, ui_element, &world->ui_elements, i);
-        mesh_push_hitbox(&mesh, ui_element.hitbox, (Color) { 100.0f, 0.0f, 0.0f, 10.0f });
+        mesh_push_hitbox(mesh, ui_element.hitbox, (Color) { 100.0f, 0.0f, 0.0f, 10.0f });
     }
 
     UIElement topmost_ui_element;
-    if (ui_get_topmost_hit(&world->ui_elements, mouse, &topmost_ui_element, NULL)) {
-        mesh_push_hitbox(&mesh, topmost_ui_element.hitbox, (Color) { 0.0f, 0.0f, 100.0f, 10.0f });
+    if (ui_get_topmost_hit(world, &world->ui_elements, mouse, &topmost_ui_element, NULL)) {
+        mesh_push_hitbox(mesh, topmost_ui_element.hitbox, (Color) { 0.0f, 0.0f, 100.0f, 10.0f });
     }
 
-    gpu_mesh_upload(&gpu_mesh, &mesh);
-    renderer_draw_mesh(&gpu_mesh, GL_LINES);
-
-    gpu_mesh_free(&gpu_mesh);
-    mesh_free(&mesh);
+    render_queue_submit(queue, render_state_main(world, RENDER_LAYER_DEBUG, GL_LINES));
 }
 #else
 void debug_render_mouse(World* world) { (void)world; }
@@ -0,0 +1,81 @@
+#include <math.h>
+#include <string.h>
+
+#include "game/frame_scheduler.h"
+
+#include "game/animation.h"
+#include "game/freecell.h"
+#include "game/timeline.h"
+#include "game/world.h"
+#include "platform/window.h"
+#include "utils.h"
+
+static const char* FRAME_WAKE_REASON_NAMES[FRAME_WAKE_REASON_COUNT] = {
+    [FRAME_WAKE_EVENT] = "event",
+    [FRAME_WAKE_ANIMATION] = "animation",
+    [FRAME_WAKE_TIMELINE] = "timeline",
+    [FRAME_WAKE_CLOCK] = "clock",
+};
+
+void frame_scheduler_init(FrameScheduler* scheduler) {
+    memset(scheduler, 0, sizeof(FrameScheduler));
+}
+
+const char* frame_scheduler_reason_name(FrameWakeReason reason) {
+    return FRAME_WAKE_REASON_NAMES[reason];
+}
+
+// Seconds until something other than an event needs a frame, INFINITY if nothing does
+static double frame_scheduler_next_deadline(World* world, FrameWakeReason* reason) {
+    *reason = FRAME_WAKE_ANIMATION;
+    if (world->controller.screen_needs_update) {
+        return 0.0;
+    }
+    double deadline = animation_system_time_to_next_frame(&world->animation_system);
+
+    double timeline = timeline_time_to_next_event(&world->timeline);
+    if (timeline < deadline) {
+        deadline = timeline;
+        *reason = FRAME_WAKE_TIMELINE;
+    }
+
+    if (!freecell_game_over(&world->game.freecell)) {
+        double clock = world->game.clock;
+        double tick = floor(clock) + 1.0 - clock;
+        if (tick < deadline) {
+            deadline = tick;
+            *reason = FRAME_WAKE_CLOCK;
+        }
+    }
+    return deadline;
+}
+
+bool frame_scheduler_wait(FrameScheduler* scheduler, World* world) {
+    RGFW_window* window = world->window;
+    if (window_is_minimized(window)) {
+        // nothing is visible, so animations and the clock can wait until the window returns
+        event_wait();
+        scheduler->minimized_wakes++;
+        return false;
+    }
+
+    FrameWakeReason reason;
+    double deadline = frame_scheduler_next_deadline(world, &reason);
+    if (deadline <= 0.0) {
+        scheduler->wake_counts[reason]++;
+        return true;
+    }
+
+    if (isinf(deadline)) {
+        event_wait();
+        scheduler->wake_counts[FRAME_WAKE_EVENT]++;
+        return true;
+    }
+
+    uint64_t start = time_micros();
+    // round up, waking a millisecond early would only cost another wait
+    event_wait_timeout((uint32_t)ceil(deadline * 1000.0));
+    double waited = (time_micros() - start) / 1.0e6;
+    scheduler->wake_counts[waited < deadline ? FRAME_WAKE_EVENT : reason]++;
+    return true;
+}
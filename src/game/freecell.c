@@ -143,6 +143,12 @@ Freecell freecell_init(uint32_t seed) {
 }
 
 bool freecell_game_over(Freecell* freecell) {
+    for (int i = 0; i < 4; i++) {
+        if (freecell->foundation[i] == NONE || get_rank(freecell->foundation[i]) != KING) {
+            return false;
+        }
+    }
+
     for (int i = 0; i < 4; i++) {
         if (freecell->reserve[i] != NONE) {
             return false;
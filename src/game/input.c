@@ -30,6 +30,10 @@ InputAction input_on_key(RGFW_window* window, World* world, RGFW_keyEvent event)
             ia.type = INPUT_ACTION_NEW_GAME;
         } else if (key == RGFW_F1) {
             ia.type = INPUT_ACTION_TOGGLE_HELP;
+        } else if (key == RGFW_F3) {
+            ia.type = INPUT_ACTION_TOGGLE_PROFILER;
+        } else if (key == RGFW_F4) {
+            ia.type = INPUT_ACTION_DUMP_TRACE;
         } else if (key == RGFW_F11) {
             ia.type = INPUT_ACTION_TOGGLE_FULLSCREEN;
         } else if (key == RGFW_q) {
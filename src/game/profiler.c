@@ -0,0 +1,356 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef __EMSCRIPTEN__
+#include <glad/glad.h>
+#else
+#include <GLES3/gl3.h>
+#endif
+
+#include "game/profiler.h"
+
+#include "core/log.h"
+#include "game/render_system.h"
+#include "game/ui_element.h"
+#include "game/world.h"
+#include "rendering/mesh.h"
+#include "utils.h"
+
+static const char* PROFILER_PHASE_NAMES[PROFILER_PHASE_COUNT] = {
+    [PROFILER_PHASE_INPUT] = "input",
+    [PROFILER_PHASE_LAYOUT] = "ui_push_world",
+    [PROFILER_PHASE_UI_STATE] = "ui_update_element_states",
+    [PROFILER_PHASE_MESH_BUILD] = "mesh_build",
+    [PROFILER_PHASE_UPLOAD] = "ui_scene_upload",
+    [PROFILER_PHASE_DRAW] = "draw",
+    [PROFILER_PHASE_SWAP] = "swap",
+};
+
+static const char* PROFILER_STARTUP_PHASE_NAMES[PROFILER_STARTUP_PHASE_COUNT] = {
+    [PROFILER_STARTUP_WINDOW] = "window_init",
+    [PROFILER_STARTUP_ASSETS] = "assets_init",
+    [PROFILER_STARTUP_WORLD] = "world_init",
+    [PROFILER_STARTUP_FIRST_FRAME] = "first_frame",
+    [PROFILER_STARTUP_AUDIO] = "audio_start",
+    [PROFILER_STARTUP_SOUND_BANK] = "sound_bank",
+};
+
+ProfilerStartup profiler_startup = { 0 };
+
+void profiler_startup_begin(ProfilerStartupPhase phase) {
+    uint64_t now = time_micros();
+    if (profiler_startup.origin_micros == 0) {
+        profiler_startup.origin_micros = now;
+    }
+    profiler_startup.phase_start[phase] = now;
+}
+
+void profiler_startup_end(ProfilerStartupPhase phase) {
+    profiler_startup.phase_micros[phase] = time_micros() - profiler_startup.phase_start[phase];
+}
+
+void profiler_startup_interactive(void) {
+    if (profiler_startup.interactive_micros == 0) {
+        profiler_startup.interactive_micros = time_micros() - profiler_startup.origin_micros;
+    }
+}
+
+void profiler_startup_report(void) {
+    for (size_t phase = 0; phase < PROFILER_STARTUP_PHASE_COUNT; phase++) {
+        log_info(
+            "startup %-12s %7.2f ms",
+            PROFILER_STARTUP_PHASE_NAMES[phase],
+            profiler_startup.phase_micros[phase] / 1000.0
+        );
+    }
+    log_info("time to interactive %.2f ms", profiler_startup.interactive_micros / 1000.0);
+}
+
+void profiler_init(Profiler* profiler) {
+    memset(profiler, 0, sizeof(Profiler));
+
+    profiler->trace = calloc(PROFILER_TRACE_EVENT_COUNT, sizeof(ProfilerTraceEvent));
+    if (profiler->trace == NULL) {
+        log_error("Failed to allocate the profiler trace");
+        exit(EXIT_FAILURE);
+    }
+
+#ifndef __EMSCRIPTEN__
+    // timer queries are core since GL 3.3, WebGL2 only exposes them through an extension
+    profiler->gpu_timer_supported = true;
+    glGenQueries(PROFILER_GPU_QUERY_COUNT, profiler->gpu_queries);
+#endif
+}
+
+void profiler_free(Profiler* profiler) {
+#ifndef __EMSCRIPTEN__
+    glDeleteQueries(PROFILER_GPU_QUERY_COUNT, profiler->gpu_queries);
+#endif
+    free(profiler->trace);
+    profiler->trace = NULL;
+}
+
+static void profiler_collect_gpu_queries(Profiler* profiler) {
+#ifndef __EMSCRIPTEN__
+    for (uint32_t i = 0; i < PROFILER_GPU_QUERY_COUNT; i++) {
+        if (!profiler->gpu_query_pending[i]) {
+            continue;
+        }
+
+        GLint available = 0;
+        glGetQueryObjectiv(profiler->gpu_queries[i], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            continue;
+        }
+
+        GLuint64 nanos = 0;
+        glGetQueryObjectui64v(profiler->gpu_queries[i], GL_QUERY_RESULT, &nanos);
+        profiler->gpu_query_pending[i] = false;
+
+        size_t index = profiler->gpu_sample_index;
+        profiler->gpu_samples[index] = (float)(nanos / 1.0e6);
+        profiler->gpu_trace[index] = (ProfilerTraceEvent) {
+            .phase = PROFILER_PHASE_COUNT,
+            .start_micros = profiler->gpu_query_start[i],
+            .duration_micros = nanos / 1000,
+        };
+        profiler->gpu_sample_index = (index + 1) % PROFILER_SAMPLE_COUNT;
+        if (profiler->gpu_sample_count < PROFILER_SAMPLE_COUNT) {
+            profiler->gpu_sample_count++;
+        }
+    }
+#else
+    (void)profiler;
+#endif
+}
+
+void profiler_begin_frame(Profiler* profiler) {
+    profiler->in_frame = true;
+    memset(profiler->phase_micros, 0, sizeof(profiler->phase_micros));
+    renderer_stats_reset();
+
+#ifndef __EMSCRIPTEN__
+    uint32_t query = profiler->gpu_query_index;
+    // a query still waiting for its result can't be reused, skip timing this frame
+    if (profiler->show_overlay && profiler->gpu_timer_supported
+        && !profiler->gpu_query_pending[query]) {
+        glBeginQuery(GL_TIME_ELAPSED, profiler->gpu_queries[query]);
+        profiler->gpu_query_start[query] = time_micros();
+        profiler->gpu_query_pending[query] = true;
+        profiler->gpu_query_active = true;
+    }
+#endif
+}
+
+void profiler_end_frame(Profiler* profiler) {
+    if (!profiler->in_frame) {
+        return;
+    }
+    profiler->in_frame = false;
+
+#ifndef __EMSCRIPTEN__
+    if (profiler->gpu_query_active) {
+        glEndQuery(GL_TIME_ELAPSED);
+        profiler->gpu_query_active = false;
+        profiler->gpu_query_index = (profiler->gpu_query_index + 1) % PROFILER_GPU_QUERY_COUNT;
+    }
+#endif
+    profiler_collect_gpu_queries(profiler);
+
+    size_t index = profiler->sample_index;
+    for (size_t phase = 0; phase < PROFILER_PHASE_COUNT; phase++) {
+        profiler->phase_samples[phase][index] = profiler->phase_micros[phase] / 1000.0f;
+    }
+    profiler->sample_index = (index + 1) % PROFILER_SAMPLE_COUNT;
+    if (profiler->sample_count < PROFILER_SAMPLE_COUNT) {
+        profiler->sample_count++;
+    }
+
+    profiler->last_frame_stats = renderer_stats;
+}
+
+void profiler_begin(Profiler* profiler, ProfilerPhase phase) {
+    profiler->phase_start[phase] = time_micros();
+}
+
+void profiler_end(Profiler* profiler, ProfilerPhase phase) {
+    uint64_t start = profiler->phase_start[phase];
+    uint64_t duration = time_micros() - start;
+    profiler->phase_micros[phase] += duration;
+
+    profiler->trace[profiler->trace_index] = (ProfilerTraceEvent) {
+        .phase = phase,
+        .start_micros = start,
+        .duration_micros = duration,
+    };
+    profiler->trace_index = (profiler->trace_index + 1) % PROFILER_TRACE_EVENT_COUNT;
+    if (profiler->trace_count < PROFILER_TRACE_EVENT_COUNT) {
+        profiler->trace_count++;
+    }
+}
+
+static const char* PROFILER_TRACE_CATEGORIES[] = { "", "cpu", "gpu", "startup" };
+
+static void profiler_write_event(FILE* file, bool* first, const char* name, uint32_t thread,
+    ProfilerTraceEvent event) {
+    fprintf(
+        file,
+        "%s\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,"
+        "\"ts\":%llu,\"dur\":%llu}",
+        *first ? "" : ",",
+        name,
+        PROFILER_TRACE_CATEGORIES[thread],
+        thread,
+        (unsigned long long)event.start_micros,
+        (unsigned long long)event.duration_micros
+    );
+    *first = false;
+}
+
+bool profiler_dump_trace(Profiler* profiler, const char* path) {
+    FILE* file = fopen(path, "w");
+    if (file == NULL) {
+        log_error("Failed to open %s for writing", path);
+        return false;
+    }
+
+    bool first = true;
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+    // oldest event first
+    size_t start = (profiler->trace_index + PROFILER_TRACE_EVENT_COUNT - profiler->trace_count)
+        % PROFILER_TRACE_EVENT_COUNT;
+    for (size_t i = 0; i < profiler->trace_count; i++) {
+        ProfilerTraceEvent event = profiler->trace[(start + i) % PROFILER_TRACE_EVENT_COUNT];
+        profiler_write_event(file, &first, PROFILER_PHASE_NAMES[event.phase], 1, event);
+    }
+
+    for (size_t phase = 0; phase < PROFILER_STARTUP_PHASE_COUNT; phase++) {
+        ProfilerTraceEvent event = {
+            .phase = (uint32_t)phase,
+            .start_micros = profiler_startup.phase_start[phase],
+            .duration_micros = profiler_startup.phase_micros[phase],
+        };
+        profiler_write_event(file, &first, PROFILER_STARTUP_PHASE_NAMES[phase], 3, event);
+    }
+
+    // GPU time isn't tied to CPU timestamps, it is drawn from the start of the frame instead
+    size_t gpu_start =
+        (profiler->gpu_sample_index + PROFILER_SAMPLE_COUNT - profiler->gpu_sample_count)
+        % PROFILER_SAMPLE_COUNT;
+    for (size_t i = 0; i < profiler->gpu_sample_count; i++) {
+        ProfilerTraceEvent event = profiler->gpu_trace[(gpu_start + i) % PROFILER_SAMPLE_COUNT];
+        profiler_write_event(file, &first, "gpu_frame", 2, event);
+    }
+
+    fprintf(file, "\n]}\n");
+    bool ok = ferror(file) == 0;
+    fclose(file);
+    return ok;
+}
+
+static int compare_floats(const void* a, const void* b) {
+    float fa = *(const float*)a;
+    float fb = *(const float*)b;
+    return (fa > fb) - (fa < fb);
+}
+
+// Writes p50, p95 and p99 of the samples into percentiles
+static void profiler_percentiles(const float* samples, size_t count, float percentiles[3]) {
+    float sorted[PROFILER_SAMPLE_COUNT];
+    memcpy(sorted, samples, count * sizeof(float));
+    qsort(sorted, count, sizeof(float), compare_floats);
+
+    const float ranks[3] = { 0.50f, 0.95f, 0.99f };
+    for (size_t i = 0; i < 3; i++) {
+        percentiles[i] = count == 0 ? 0.0f : sorted[(size_t)(ranks[i] * (count - 1) + 0.5f)];
+    }
+}
+
+void mesh_push_profiler_overlay(Mesh* mesh, World* world) {
+    Profiler* profiler = &world->profiler;
+
+    char text[1024];
+    size_t length = 0;
+    length += snprintf(
+        text + length,
+        sizeof(text) - length,
+        "%-26s %6s %6s %6s\n",
+        "phase (ms)",
+        "p50",
+        "p95",
+        "p99"
+    );
+
+    float percentiles[3];
+    for (size_t phase = 0; phase < PROFILER_PHASE_COUNT; phase++) {
+        profiler_percentiles(profiler->phase_samples[phase], profiler->sample_count, percentiles);
+        length += snprintf(
+            text + length,
+            sizeof(text) - length,
+            "%-26s %6.2f %6.2f %6.2f\n",
+            PROFILER_PHASE_NAMES[phase],
+            percentiles[0],
+            percentiles[1],
+            percentiles[2]
+        );
+    }
+
+    if (profiler->gpu_timer_supported) {
+        profiler_percentiles(profiler->gpu_samples, profiler->gpu_sample_count, percentiles);
+        length += snprintf(
+            text + length,
+            sizeof(text) - length,
+            "%-26s %6.2f %6.2f %6.2f\n",
+            "gpu",
+            percentiles[0],
+            percentiles[1],
+            percentiles[2]
+        );
+    } else {
+        length += snprintf(text + length, sizeof(text) - length, "gpu timer unavailable\n");
+    }
+
+    RendererStats stats = profiler->last_frame_stats;
+    length += snprintf(
+        text + length,
+        sizeof(text) - length,
+        "draws %u  indices %u\nuploaded %u vertices, %zu bytes\n"
+        "interactive after %.1f ms, audio started in %.1f ms\nwakes",
+        stats.draw_calls,
+        stats.indices_drawn,
+        stats.vertices_uploaded,
+        stats.bytes_uploaded,
+        profiler_startup.interactive_micros / 1000.0,
+        profiler_startup.phase_micros[PROFILER_STARTUP_AUDIO] / 1000.0
+    );
+
+    FrameScheduler* scheduler = &world->frame_scheduler;
+    for (size_t reason = 0; reason < FRAME_WAKE_REASON_COUNT; reason++) {
+        length += snprintf(
+            text + length,
+            sizeof(text) - length,
+            " %s %llu",
+            frame_scheduler_reason_name(reason),
+            (unsigned long long)scheduler->wake_counts[reason]
+        );
+    }
+
+    UIElement style = {
+        .type = UI_TEXT,
+        .sprite = (Sprite) {
+            .x = 10.0f,
+            .y = 10.0f,
+            .z = 20.0f,
+            .color = (Color) { 1.0f, 1.0f, 0.4f, 0.9f },
+        },
+        .meta.text = {
+            .font_scaling = 0.6f,
+            .line_height_scaling = 1.0f,
+            .character_spacing_scaling = 1.0f,
+        },
+    };
+    // the numbers change every frame, caching the run would only evict the static text
+    mesh_push_transient_string(mesh, world, text, &style);
+}
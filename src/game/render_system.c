@@ -8,52 +8,68 @@
 #include "game/animation.h"
 #include "game/ui_state.h"
 #include "rendering/mesh.h"
+#include "rendering/render_target.h"
 #include "rendering/renderer.h"
 #include "rendering/shader.h"
 
 #include "game/debug.h"
+#include "game/profiler.h"
+#include "game/text_cache.h"
 #include "game/ui_element.h"
 #include "game/ui_layout.h"
+#include "game/ui_scene.h"
 #include "game/world.h"
+#include "platform/window.h"
+#include "utils.h"
 
 void mesh_push_text(Mesh* mesh, World* world, UIElement* ui_element) {
-    float x = ui_element->sprite.x;
-    float y = ui_element->sprite.y;
-    const char* text = aptr(ui_element->meta.text.text);
-
-    float offset_x = 0;
-    float offset_y = 0;
+    mesh_push_string(mesh, world, aptr(ui_element->meta.text.text), ui_element);
+}
 
+static TextStyle text_style_of(World* world, const UIElement* ui_element) {
     // assumes font width and height are the same for all characters
     // this is true for the fonts used in this game
-    float font_size = world->characters[' '].height * ui_element->meta.text.font_scaling;
-
-    float char_spacing = font_size / 2.0f * ui_element->meta.text.character_spacing_scaling;
-    float line_height = font_size * ui_element->meta.text.line_height_scaling;
-
-    size_t string_len = strlen(text);
-    for (size_t i = 0; i < string_len; i++) {
-        uint8_t c = text[i];
-        if (c == '\n') {
-            offset_x = 0;
-            offset_y += line_height;
-        } else if (c == ' ') {
-            offset_x += char_spacing;
-        } else if (c == '\t') {
-            // one tab should be equal to 4 spaces :P
-            offset_x += char_spacing * 4;
-        } else {
-            Sprite sprite = world->characters[c];
-            sprite.color = ui_element->sprite.color;
-            sprite.x = offset_x + x;
-            sprite.y = offset_y + y;
-            sprite.z = ui_element->sprite.z;
-            sprite.width = font_size;
-            sprite.height = font_size;
-            mesh_push_sprite(&world->game_mesh, sprite);
-            offset_x += char_spacing;
-        }
-    }
+    return (TextStyle) {
+        .glyph_size = world->characters[' '].height,
+        .font_scaling = ui_element->meta.text.font_scaling,
+        .line_height_scaling = ui_element->meta.text.line_height_scaling,
+        .character_spacing_scaling = ui_element->meta.text.character_spacing_scaling,
+    };
+}
+
+static TextPlacement text_placement_of(const UIElement* ui_element) {
+    return (TextPlacement) {
+        .x = ui_element->sprite.x,
+        .y = ui_element->sprite.y,
+        .z = ui_element->sprite.z,
+        .color = ui_element->sprite.color,
+    };
+}
+
+void mesh_push_string(Mesh* mesh, World* world, const char* text, const UIElement* ui_element) {
+    text_cache_push(
+        &world->text_cache,
+        mesh,
+        world->characters,
+        text,
+        text_style_of(world, ui_element),
+        text_placement_of(ui_element)
+    );
+}
+
+void mesh_push_transient_string(
+    Mesh* mesh,
+    World* world,
+    const char* text,
+    const UIElement* ui_element
+) {
+    text_layout_push(
+        mesh,
+        world->characters,
+        text,
+        text_style_of(world, ui_element),
+        text_placement_of(ui_element)
+    );
 }
 
 void mesh_push_ui_element(Mesh* mesh, World* world, UIElement* ui_element) {
@@ -64,65 +80,157 @@ void mesh_push_ui_element(Mesh* mesh, World* world, UIElement* ui_element) {
     }
 }
 
-void mesh_push_ui_elements(Mesh* mesh, World* world, Vector* ui_elements) {
-    AnimationSystem* anim_sys = &world->animation_system;
-    for (size_t i = 0; i < ui_elements->size; i++) {
-        vec_get_as(UIElement, element, ui_elements, i);
-        if (!animation_system_is_animated(anim_sys, &element)) {
-            mesh_push_ui_element(mesh, world, &element);
-        }
-    }
-}
-
 void mesh_push_animations(Mesh* mesh, World* world) {
     // animate ui elements
     AnimationSystem* animation_system = &world->animation_system;
-    for (size_t i = 0; i < animation_system->ui_animations.size; i++) {
-        vec_get_as(UIElementAnimation, animation, &animation_system->ui_animations, i);
-        UIElement ui_element = animation_system_get_next_frame(animation_system, &animation);
-        if (animation.elapsed > 0) {
+    animation_system_interpolate(animation_system);
+    for (size_t i = 0; i < animation_system_count(animation_system); i++) {
+        UIElement ui_element;
+        if (animation_system_get_frame(animation_system, i, &ui_element)) {
             mesh_push_ui_element(mesh, world, &ui_element);
         }
     }
 }
 
+// Every card and button can be highlighted at once, at most
+#define RENDER_HIGHLIGHT_MAX 64
+
+static bool render_is_element_in_board(World* world, UIElement* element) {
+    return !animation_system_is_animated(&world->animation_system, element)
+        && !ui_is_element_dragged(world, element);
+}
+
+/** Pushes the highlighted elements, drawn over their plain copies in the board.
+ * Elements drawn after a highlighted one that overlap it are pushed again as well, so that
+ * whatever covers it in the board still covers it.
+ */
+static void mesh_push_highlights(Mesh* mesh, World* world) {
+    Rect highlighted[RENDER_HIGHLIGHT_MAX];
+    size_t highlighted_count = 0;
+
+    for (size_t i = 0; i < world->ui_elements.size; i++) {
+        UIElement* element = vec_get(&world->ui_elements, i);
+        if (!render_is_element_in_board(world, element)) {
+            continue;
+        }
+
+        Rect bounds = {
+            .x = element->sprite.x,
+            .y = element->sprite.y,
+            .width = element->sprite.width,
+            .height = element->sprite.height,
+        };
+        bool covers_highlight = false;
+        for (size_t k = 0; k < highlighted_count && !covers_highlight; k++) {
+            covers_highlight = rects_overlap(highlighted[k], bounds);
+        }
+
+        if (ui_is_element_highlighted(element) && highlighted_count < RENDER_HIGHLIGHT_MAX) {
+            highlighted[highlighted_count++] = bounds;
+            mesh_push_ui_element(mesh, world, element);
+        } else if (covers_highlight) {
+            mesh_push_ui_element(mesh, world, element);
+        }
+    }
+}
+
 static int set_state = false;
 static void render_set_static_state_once(World* world) {
     if (!set_state) {
         set_state = true;
+        // unit 0 is bound last, the render queue and render targets rebind the active unit
+        renderer_bind_texture(1, GL_TEXTURE_2D, world->assets.glyph_atlas_texture);
         renderer_bind_texture(0, GL_TEXTURE_2D, world->assets.spritesheet_texture);
-        renderer_set_shader(world->assets.main_shader);
-        shader_set_mat4(world->assets.main_shader, "view", (const float*)world->camera.view);
-        shader_set_mat4(
-            world->assets.main_shader,
-            "projection",
-            (const float*)world->camera.projection
-        );
-        shader_set_int(world->assets.main_shader, "spritesheet", 0);
+        const Shader* shader = &world->assets.main_shader;
+        renderer_set_shader(shader->program);
+        // the camera comes from its uniform buffer, only the samplers are set here
+        shader_set_int(shader, MAIN_SHADER_SPRITESHEET, 0);
+        shader_set_int(shader, MAIN_SHADER_GLYPH_ATLAS, 1);
     }
 }
 
+RenderState render_state_main(World* world, uint8_t layer, GLenum primitive) {
+    return (RenderState) {
+        .layer = layer,
+        .shader = world->assets.main_shader.program,
+        .texture = world->assets.spritesheet_texture,
+        .blend = BLEND_ALPHA,
+        .primitive = primitive,
+    };
+}
+
 void render_world(World* world) {
-    // layout the world
-    world->ui_elements.size = 0;
-    ui_push_world(&world->ui_elements, world);
+    UIScene* scene = &world->ui_scene;
+
+    Profiler* profiler = &world->profiler;
+
+    // layout the world, only if the game changed since the last frame
+    profiler_begin(profiler, PROFILER_PHASE_LAYOUT);
+    ui_scene_update_layout(scene, world);
+    profiler_end(profiler, PROFILER_PHASE_LAYOUT);
 
     // update ui elements state
+    profiler_begin(profiler, PROFILER_PHASE_UI_STATE);
     ui_update_element_states(world);
+    profiler_end(profiler, PROFILER_PHASE_UI_STATE);
+
+    // patch the retained mesh where elements changed
+    // animated elements keep their slot but are hidden, the animation draws them instead
+    // dragged cards are hidden as well and streamed every frame, so the board stays cached
+    // highlighted elements keep their plain look in the board and are streamed over it
+    profiler_begin(profiler, PROFILER_PHASE_MESH_BUILD);
+    RenderQueue* queue = &world->render_queue;
+    AnimationSystem* anim_sys = &world->animation_system;
+    animation_system_mark_animated(anim_sys);
+    for (size_t i = 0; i < world->ui_elements.size; i++) {
+        UIElement* element = vec_get(&world->ui_elements, i);
+        bool animated = animation_system_is_animated(anim_sys, element);
+        bool dragged = ui_is_element_dragged(world, element);
+
+        const UIElement* board_element = element;
+        if (!animated && !dragged && ui_is_element_highlighted(element)) {
+            board_element = vec_get(&scene->layout, i);
+        }
+        ui_scene_sync_element(scene, i, board_element, animated || dragged);
 
-    // create game mesh and upload to gpu
-    mesh_clear(&world->game_mesh);
-    mesh_push_ui_elements(&world->game_mesh, world, &world->ui_elements);
-    mesh_push_animations(&world->game_mesh, world);
-    gpu_mesh_upload(&world->game_gpu_mesh, &world->game_mesh);
+        if (dragged && !animated) {
+            mesh_push_ui_element(render_queue_mesh(queue), world, element);
+        }
+    }
+    render_queue_submit(queue, render_state_main(world, RENDER_LAYER_DRAG, GL_TRIANGLES));
 
-    // draw
-    renderer_clear(BACKGROUND_COLOR);
-    render_set_static_state_once(world);
-    renderer_draw_mesh(&world->game_gpu_mesh, GL_TRIANGLES);
+    mesh_push_highlights(render_queue_mesh(queue), world);
+    render_queue_submit(queue, render_state_main(world, RENDER_LAYER_HIGHLIGHT, GL_TRIANGLES));
+    profiler_end(profiler, PROFILER_PHASE_MESH_BUILD);
+
+    profiler_begin(profiler, PROFILER_PHASE_UPLOAD);
+    ui_scene_upload(scene, world);
+    profiler_end(profiler, PROFILER_PHASE_UPLOAD);
+
+    profiler_begin(profiler, PROFILER_PHASE_MESH_BUILD);
+    // animations change every frame, so they are streamed through the queue
+    mesh_push_animations(render_queue_mesh(queue), world);
+    render_queue_submit(queue, render_state_main(world, RENDER_LAYER_ANIMATION, GL_TRIANGLES));
 
 #ifdef FREECELL_DEBUG
     debug_render_mouse(world);
     debug_render_hit_hitbox(world);
 #endif
+
+    if (profiler->show_overlay) {
+        mesh_push_profiler_overlay(render_queue_mesh(queue), world);
+        render_queue_submit(queue, render_state_main(world, RENDER_LAYER_DEBUG, GL_TRIANGLES));
+    }
+    profiler_end(profiler, PROFILER_PHASE_MESH_BUILD);
+
+    // draw the cached board, then everything that moves on top of it
+    profiler_begin(profiler, PROFILER_PHASE_DRAW);
+    render_set_static_state_once(world);
+    int width, height;
+    window_get_size(world->window, &width, &height);
+    ui_scene_draw_board(scene, world, width, height);
+    render_target_blit_to_screen(&scene->board_target);
+    renderer_clear_depth();
+    render_queue_flush(queue);
+    profiler_end(profiler, PROFILER_PHASE_DRAW);
 }
@@ -4,20 +4,26 @@ out vec4 FragColor;
 
 in vec4 outColor;
 in vec2 tex_coords;
+in float textured;
+in float sdf;
 
 uniform sampler2D spritesheet;
+uniform sampler2D glyph_atlas;
 
 void main()
 {
     vec4 texColor = vec4(1.0);
 
-    if (!(isinf(tex_coords.x) || isnan(tex_coords.x))) {
+    if (sdf > 0.5) {
+        // the edge is at 0.5, smoothed over one screen pixel at any scale
+        float distance = texture(glyph_atlas, tex_coords).r;
+        float width = max(fwidth(distance) * 0.5, 0.001);
+        texColor = vec4(smoothstep(0.5 - width, 0.5 + width, distance));
+    } else if (textured > 0.5) {
+        // the atlas is premultiplied
         texColor = texture(spritesheet, tex_coords);
     }
 
-    if (texColor.a < 0.1)
-        discard;
-
-    FragColor = texColor * outColor;
+    // premultiplied output, blended with GL_ONE, GL_ONE_MINUS_SRC_ALPHA
+    FragColor = texColor * vec4(outColor.rgb * outColor.a, outColor.a);
 }
-
@@ -3,25 +3,27 @@ precision mediump float;
 
 in vec4 outColor;
 in vec2 tex_coords;
+in float textured;
+in float sdf;
 
 uniform sampler2D spritesheet;
+uniform sampler2D glyph_atlas;
 
 out vec4 FragColor;
 
 void main() {
     vec4 texColor = vec4(1.0);
 
-    // GLSL ES doesn't have isinf/isnan built-in, so we need a workaround
-
-    // Check if tex_coords are valid (not NaN or Inf) by a safe clamp trick
-    // NaN and Inf cause comparisons to fail, so this is a common check:
-    if (all(greaterThanEqual(tex_coords, vec2(0.0))) && all(lessThanEqual(tex_coords, vec2(1.0)))) {
+    if (sdf > 0.5) {
+        // the edge is at 0.5, smoothed over one screen pixel at any scale
+        float distance = texture(glyph_atlas, tex_coords).r;
+        float width = max(fwidth(distance) * 0.5, 0.001);
+        texColor = vec4(smoothstep(0.5 - width, 0.5 + width, distance));
+    } else if (textured > 0.5) {
+        // the atlas is premultiplied
         texColor = texture(spritesheet, tex_coords);
     }
 
-    if (texColor.a < 0.1) {
-        discard;
-    }
-
-    FragColor = texColor * outColor;
+    // premultiplied output, blended with GL_ONE, GL_ONE_MINUS_SRC_ALPHA
+    FragColor = texColor * vec4(outColor.rgb * outColor.a, outColor.a);
 }
@@ -1,17 +1,30 @@
 #version 330 core
 
-layout (location = 0) in vec3 aPos;
+layout (location = 0) in vec2 aPos;
 layout (location = 1) in vec4 aColor;
 layout (location = 2) in vec2 tex_coords_in;
+layout (location = 3) in float aDepth;
+layout (location = 4) in uint aFlags;
 
 out vec4 outColor;
 out vec2 tex_coords;
+out float textured;
+out float sdf;
 
-uniform mat4 projection;
-uniform mat4 view;
+// Keep in sync with Camera in camera.h, the block is shared by every shader
+layout(std140) uniform Camera {
+    mat4 projection;
+    mat4 view;
+};
+
+// Keep in sync with VertexFlags in mesh.h
+const uint VERTEX_FLAG_UNTEXTURED = 1u;
+const uint VERTEX_FLAG_SDF = 2u;
 
 void main() {
-   gl_Position = projection * view * vec4(aPos.x, aPos.y, aPos.z, 1.0);
+   gl_Position = projection * view * vec4(aPos.x, aPos.y, aDepth, 1.0);
    tex_coords = tex_coords_in;
+   textured = (aFlags & VERTEX_FLAG_UNTEXTURED) == 0u ? 1.0 : 0.0;
+   sdf = (aFlags & VERTEX_FLAG_SDF) != 0u ? 1.0 : 0.0;
    outColor = aColor;
 }
@@ -0,0 +1,165 @@
+#include <math.h>
+#include <string.h>
+
+#include "game/text_cache.h"
+
+#include "utils.h"
+
+void text_cache_init(TextCache* cache) {
+    memset(cache, 0, sizeof(TextCache));
+    for (size_t i = 0; i < TEXT_CACHE_RUN_COUNT; i++) {
+        cache->runs[i].text = vec_init(sizeof(char));
+        cache->runs[i].mesh = mesh_init();
+    }
+}
+
+void text_cache_free(TextCache* cache) {
+    for (size_t i = 0; i < TEXT_CACHE_RUN_COUNT; i++) {
+        vec_free(&cache->runs[i].text);
+        mesh_free(&cache->runs[i].mesh);
+    }
+}
+
+static uint64_t text_cache_key(const char* text, size_t length, TextStyle style) {
+    uint64_t key = hash_bytes(text, length) * 31 + hash_bytes(&style, sizeof(style));
+    // 0 marks an unused run
+    return key == 0 ? 1 : key;
+}
+
+static void text_run_measure(TextRun* run, const char* text, size_t length, TextStyle style) {
+    float font_size = style.glyph_size * style.font_scaling;
+    float char_spacing = font_size / 2.0f * style.character_spacing_scaling;
+    float line_height = font_size * style.line_height_scaling;
+
+    float offset_x = 0;
+    float max_width = 0;
+    uint32_t num_lines = length == 0 ? 0 : 1;
+    for (size_t i = 0; i < length; i++) {
+        uint8_t c = text[i];
+        if (c == '\n') {
+            offset_x = 0;
+            num_lines++;
+        } else if (c == '\t') {
+            // one tab should be equal to 4 spaces :P
+            offset_x += char_spacing * 4;
+        } else {
+            offset_x += char_spacing;
+        }
+        max_width = fmaxf(max_width, offset_x);
+    }
+
+    run->width = max_width;
+    run->height = num_lines * line_height;
+}
+
+static bool text_run_matches(
+    TextRun* run,
+    uint64_t key,
+    const char* text,
+    size_t length,
+    TextStyle style
+) {
+    return run->key == key && run->text.size == length
+        && memcmp(run->text.data, text, length) == 0
+        && memcmp(&run->style, &style, sizeof(style)) == 0;
+}
+
+TextRun* text_cache_get(TextCache* cache, const char* text, TextStyle style) {
+    size_t length = strlen(text);
+    uint64_t key = text_cache_key(text, length, style);
+    cache->clock++;
+
+    TextRun* oldest = &cache->runs[0];
+    for (size_t i = 0; i < TEXT_CACHE_RUN_COUNT; i++) {
+        TextRun* run = &cache->runs[i];
+        if (text_run_matches(run, key, text, length, style)) {
+            run->last_used = cache->clock;
+            return run;
+        }
+        if (run->key == 0 || (oldest->key != 0 && run->last_used < oldest->last_used)) {
+            oldest = run;
+        }
+    }
+
+    oldest->key = key;
+    oldest->last_used = cache->clock;
+    vec_ensure_capacity(&oldest->text, length + 1);
+    memcpy(oldest->text.data, text, length + 1);
+    oldest->text.size = length;
+    oldest->style = style;
+    oldest->built = false;
+    mesh_clear(&oldest->mesh);
+    text_run_measure(oldest, text, length, style);
+    return oldest;
+}
+
+void text_layout_push(
+    Mesh* mesh,
+    const Sprite characters[256],
+    const char* text,
+    TextStyle style,
+    TextPlacement placement
+) {
+    size_t first_vertex = mesh->vertices.size;
+
+    float font_size = style.glyph_size * style.font_scaling;
+    float char_spacing = font_size / 2.0f * style.character_spacing_scaling;
+    float line_height = font_size * style.line_height_scaling;
+
+    float offset_x = 0;
+    float offset_y = 0;
+    for (size_t i = 0; text[i] != '\0'; i++) {
+        uint8_t c = text[i];
+        if (c == '\n') {
+            offset_x = 0;
+            offset_y += line_height;
+        } else if (c == ' ') {
+            offset_x += char_spacing;
+        } else if (c == '\t') {
+            offset_x += char_spacing * 4;
+        } else {
+            Sprite sprite = characters[c];
+            sprite.color = placement.color;
+            sprite.x = offset_x + placement.x;
+            sprite.y = offset_y + placement.y;
+            sprite.z = placement.z;
+            sprite.width = font_size;
+            sprite.height = font_size;
+            mesh_push_sprite(mesh, sprite);
+            offset_x += char_spacing;
+        }
+    }
+
+    Vertex* vertices = mesh->vertices.data;
+    for (size_t i = first_vertex; i < mesh->vertices.size; i++) {
+        vertices[i].flags |= VERTEX_FLAG_SDF;
+    }
+}
+
+static void text_run_build(
+    TextRun* run,
+    const Sprite characters[256],
+    const char* text,
+    TextStyle style,
+    TextPlacement placement
+) {
+    mesh_clear(&run->mesh);
+    text_layout_push(&run->mesh, characters, text, style, placement);
+    run->placement = placement;
+    run->built = true;
+}
+
+void text_cache_push(
+    TextCache* cache,
+    Mesh* mesh,
+    const Sprite characters[256],
+    const char* text,
+    TextStyle style,
+    TextPlacement placement
+) {
+    TextRun* run = text_cache_get(cache, text, style);
+    if (!run->built || memcmp(&run->placement, &placement, sizeof(placement)) != 0) {
+        text_run_build(run, characters, text, style, placement);
+    }
+    mesh_append(mesh, &run->mesh);
+}
@@ -0,0 +1,102 @@
+#include <math.h>
+#include <string.h>
+
+#include "game/timeline.h"
+
+Timeline timeline_init(void) {
+    Timeline timeline = {
+        .time = 0.0,
+        .events = vec_init(sizeof(TimelineEvent)),
+        .next_event = 0,
+    };
+    return timeline;
+}
+
+void timeline_free(Timeline* timeline) { vec_free(&timeline->events); }
+
+void timeline_clear(Timeline* timeline) {
+    timeline->events.size = 0;
+    timeline->next_event = 0;
+    timeline->time = 0.0;
+}
+
+void timeline_add_animation(
+    AnimationSystem* animation_system,
+    double delay,
+    const UIElementAnimation* animation
+) {
+    UIElementAnimation delayed = *animation;
+    delayed.elapsed -= (float)delay;
+    animation_system_push(animation_system, &delayed);
+}
+
+void timeline_add_stagger(
+    AnimationSystem* animation_system,
+    double delay,
+    double interval,
+    const UIElementAnimation* animations,
+    size_t count
+) {
+    for (size_t i = 0; i < count; i++) {
+        timeline_add_animation(animation_system, delay + interval * i, &animations[i]);
+    }
+}
+
+void timeline_add_callback(
+    Timeline* timeline,
+    double delay,
+    TimelineCallback callback,
+    uint32_t argument
+) {
+    TimelineEvent event = {
+        .time = timeline->time + delay,
+        .callback = callback,
+        .argument = argument,
+    };
+
+    // events are mostly added in order, so search for the insertion point from the back
+    size_t index = timeline->events.size;
+    while (index > timeline->next_event) {
+        TimelineEvent* previous = vec_get(&timeline->events, index - 1);
+        if (previous->time <= event.time) {
+            break;
+        }
+        index--;
+    }
+
+    vec_push_back(&timeline->events, &event);
+    if (index != timeline->events.size - 1) {
+        TimelineEvent* events = timeline->events.data;
+        size_t moved = timeline->events.size - 1 - index;
+        memmove(&events[index + 1], &events[index], moved * sizeof(TimelineEvent));
+        events[index] = event;
+    }
+}
+
+void timeline_update(Timeline* timeline, World* world, double delta_time) {
+    timeline->time += delta_time;
+
+    // callbacks may schedule more events, so the vector is re-read every iteration
+    while (timeline->next_event < timeline->events.size) {
+        TimelineEvent event = *(TimelineEvent*)vec_get(&timeline->events, timeline->next_event);
+        if (event.time > timeline->time) {
+            break;
+        }
+        timeline->next_event++;
+        event.callback(world, event.argument);
+    }
+
+    if (timeline->next_event == timeline->events.size) {
+        // everything fired, restart the clock so it never loses precision
+        timeline_clear(timeline);
+    }
+}
+
+double timeline_time_to_next_event(const Timeline* timeline) {
+    if (timeline->next_event >= timeline->events.size) {
+        return INFINITY;
+    }
+    const TimelineEvent* events = timeline->events.data;
+    double remaining = events[timeline->next_event].time - timeline->time;
+    return remaining > 0.0 ? remaining : 0.0;
+}
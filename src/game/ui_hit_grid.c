@@ -0,0 +1,127 @@
+#include <math.h>
+#include <string.h>
+
+#include "game/ui_hit_grid.h"
+
+#include "game/constants.h"
+#include "game/ui_element.h"
+
+#include "utils.h"
+
+UIHitGrid ui_hit_grid_init(void) {
+    UIHitGrid grid = { 0 };
+    grid.cell_width = (float)VIRTUAL_WIDTH / UI_HIT_GRID_COLUMNS;
+    grid.cell_height = (float)VIRTUAL_HEIGHT / UI_HIT_GRID_ROWS;
+    grid.indices = vec_init(sizeof(uint16_t));
+    return grid;
+}
+
+void ui_hit_grid_free(UIHitGrid* grid) { vec_free(&grid->indices); }
+
+static int ui_hit_grid_clamp(float value, int max) {
+    if (!(value >= 0.0f)) {
+        return 0;
+    }
+    return value >= (float)max ? max - 1 : (int)value;
+}
+
+typedef struct UIHitGridSpan {
+    int min_column, max_column;
+    int min_row, max_row;
+} UIHitGridSpan;
+
+// Cells covered by a hitbox, hitboxes outside the screen are kept in the border cells
+static bool ui_hit_grid_span(const UIHitGrid* grid, Rect hitbox, UIHitGridSpan* span) {
+    if (!isfinite(hitbox.x) || !isfinite(hitbox.y) || hitbox.width <= 0.0f
+        || hitbox.height <= 0.0f) {
+        return false;
+    }
+
+    float left = hitbox.x - hitbox.width / 2.0f;
+    float right = hitbox.x + hitbox.width / 2.0f;
+    float top = hitbox.y - hitbox.height / 2.0f;
+    float bottom = hitbox.y + hitbox.height / 2.0f;
+
+    span->min_column = ui_hit_grid_clamp(left / grid->cell_width, UI_HIT_GRID_COLUMNS);
+    span->max_column = ui_hit_grid_clamp(right / grid->cell_width, UI_HIT_GRID_COLUMNS);
+    span->min_row = ui_hit_grid_clamp(top / grid->cell_height, UI_HIT_GRID_ROWS);
+    span->max_row = ui_hit_grid_clamp(bottom / grid->cell_height, UI_HIT_GRID_ROWS);
+    return true;
+}
+
+void ui_hit_grid_build(UIHitGrid* grid, Vector* layout) {
+    uint32_t counts[UI_HIT_GRID_CELLS] = { 0 };
+
+    for (size_t i = 0; i < layout->size; i++) {
+        UIElement* element = vec_get(layout, i);
+        UIHitGridSpan span;
+        if (!ui_hit_grid_span(grid, element->hitbox, &span)) {
+            continue;
+        }
+        for (int row = span.min_row; row <= span.max_row; row++) {
+            for (int column = span.min_column; column <= span.max_column; column++) {
+                counts[row * UI_HIT_GRID_COLUMNS + column]++;
+            }
+        }
+    }
+
+    uint32_t total = 0;
+    for (size_t cell = 0; cell < UI_HIT_GRID_CELLS; cell++) {
+        grid->cell_start[cell] = total;
+        total += counts[cell];
+        counts[cell] = grid->cell_start[cell];
+    }
+    grid->cell_start[UI_HIT_GRID_CELLS] = total;
+
+    vec_ensure_capacity(&grid->indices, total);
+    grid->indices.size = total;
+    uint16_t* indices = grid->indices.data;
+
+    // later elements are drawn on top, walking backwards keeps every cell topmost first
+    for (size_t i = layout->size; i-- > 0;) {
+        UIElement* element = vec_get(layout, i);
+        UIHitGridSpan span;
+        if (!ui_hit_grid_span(grid, element->hitbox, &span)) {
+            continue;
+        }
+        for (int row = span.min_row; row <= span.max_row; row++) {
+            for (int column = span.min_column; column <= span.max_column; column++) {
+                indices[counts[row * UI_HIT_GRID_COLUMNS + column]++] = (uint16_t)i;
+            }
+        }
+    }
+}
+
+bool ui_hit_grid_query(
+    const UIHitGrid* grid,
+    Vector* ui_elements,
+    vec2s point,
+    UIElement* topmost,
+    size_t* index
+) {
+    int column = ui_hit_grid_clamp(point.x / grid->cell_width, UI_HIT_GRID_COLUMNS);
+    int row = ui_hit_grid_clamp(point.y / grid->cell_height, UI_HIT_GRID_ROWS);
+    size_t cell = row * UI_HIT_GRID_COLUMNS + column;
+
+    const uint16_t* indices = grid->indices.data;
+    for (uint32_t i = grid->cell_start[cell]; i < grid->cell_start[cell + 1]; i++) {
+        size_t element_index = indices[i];
+        if (element_index >= ui_elements->size) {
+            continue;
+        }
+
+        UIElement* element = vec_get(ui_elements, element_index);
+        if (point_in_rect(point.x, point.y, element->hitbox)) {
+            if (index != NULL) {
+                *index = element_index;
+            }
+
+            if (topmost != NULL) {
+                *topmost = *element;
+            }
+            return true;
+        }
+    }
+
+    return false;
+}
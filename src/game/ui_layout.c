@@ -1,3 +1,5 @@
+#include <string.h>
+
 #include "game/ui_layout.h"
 
 #include "core/aalloc.h"
@@ -6,8 +8,10 @@
 #include "game/game.h"
 #include "game/constants.h"
 #include "game/ui_element.h"
+#include "game/ui_hit_grid.h"
 #include "game/ui_sprites.h"
 #include "game/ui_state.h"
+#include "game/text_cache.h"
 #include "game/world.h"
 
 #include "utils.h"
@@ -22,31 +26,44 @@ static Rect empty_hitbox(void) {
 }
 
 bool ui_find_in_layout(
-    Vector* ui_elements,
+    World* world,
     SelectionLocation location,
     uint32_t card_index,
     UIElement* dest,
     size_t* dest_idx
 ) {
-    for (size_t i = 0; i < ui_elements->size; i++) {
-        vec_get_as(UIElement, element, ui_elements, i);
-        if (element.type == UI_CARD && element.meta.card.selection_location == location
-            && element.meta.card.card_index == (int)card_index) {
-            if (dest != NULL) {
-                *dest = element;
-            }
+    const UICardLookup* lookup = &world->ui_scene.card_lookup;
+    Vector* ui_elements = &world->ui_elements;
+    if (location >= UI_CARD_LOOKUP_LOCATIONS || card_index >= UI_CARD_LOOKUP_INDICES) {
+        return false;
+    }
 
-            if (dest_idx != NULL) {
-                *dest_idx = i;
-            }
-            return true;
-        }
+    int16_t i = lookup->element_index[location][card_index];
+    if (i < 0 || (size_t)i >= ui_elements->size) {
+        return false;
+    }
+
+    if (dest != NULL) {
+        *dest = *(UIElement*)vec_get(ui_elements, i);
     }
 
-    return false;
+    if (dest_idx != NULL) {
+        *dest_idx = i;
+    }
+    return true;
 }
 
-static void ui_push_freecells(Vector* vec, World* world) {
+// Pushes an element, recording where cards end up so they can be found without a scan
+static void ui_push_element(Vector* vec, UICardLookup* lookup, const UIElement* element) {
+    if (element->type == UI_CARD) {
+        SelectionLocation location = element->meta.card.selection_location;
+        int card_index = element->meta.card.card_index;
+        lookup->element_index[location][card_index] = (int16_t)vec->size;
+    }
+    vec_push_back(vec, element);
+}
+
+static void ui_push_freecells(Vector* vec, UICardLookup* lookup, World* world) {
     Sprite* deck = world->deck;
     Freecell* freecell = &world->game.freecell;
 
@@ -61,7 +78,7 @@ static void ui_push_freecells(Vector* vec, World* world) {
         none_card.y = none_card.height / 2.f + MARGIN_Y;
         none_card.z = 0.0f;
         none_card.color.a = 0.3f;
-        vec_push_back(vec, &(UIElement) {
+        ui_push_element(vec, lookup, &(UIElement) {
             .type = UI_CARD_PLACEHOLDER,
             .sprite = none_card,
             .hitbox = empty_hitbox(),
@@ -97,13 +114,16 @@ static void ui_push_freecells(Vector* vec, World* world) {
             },
         };
 
-        vec_push_back(vec, &ui_element);
+        ui_push_element(vec, lookup, &ui_element);
     }
 }
 
-static void ui_push_foundation(Vector* vec, World* world) {
+static void ui_push_foundation(Vector* vec, UICardLookup* lookup, World* world) {
     Sprite* deck = world->deck;
-    Freecell* freecell = &world->game.freecell;
+    // the win sequence takes the cards off a copy, the game stays won meanwhile
+    const Card* foundation = world->controller.game_over_scheduled
+        ? world->controller.game_over_foundation
+        : world->game.freecell.foundation;
 
     const int MARGIN_Y = 30;
     const int MARGIN_X = 30;
@@ -111,7 +131,7 @@ static void ui_push_foundation(Vector* vec, World* world) {
 
     for (int i = 0; i < 4; i++) {
         // Placeholder when no card is present
-        Card none_card = freecell->foundation[i];
+        Card none_card = foundation[i];
         float none_alpha = 1.0f;
         if (none_card == NONE || get_rank(none_card) == ACE) {
             none_card = ACE_SPADES + 13 * i;
@@ -125,7 +145,7 @@ static void ui_push_foundation(Vector* vec, World* world) {
         none_sprite.y = none_sprite.height / 2.f + MARGIN_Y;
         none_sprite.z = 0.0f;
         none_sprite.color.a = none_alpha;
-        vec_push_back(vec, &(UIElement) {
+        ui_push_element(vec, lookup, &(UIElement) {
             .type = UI_CARD_PLACEHOLDER,
             .sprite = none_sprite,
             .hitbox = empty_hitbox(),
@@ -139,7 +159,7 @@ static void ui_push_foundation(Vector* vec, World* world) {
         });
 
         // Actual card
-        Card card = freecell->foundation[i];
+        Card card = foundation[i];
         Sprite sprite = deck[card];
         if (card == NONE) {
             sprite.color.a = 0.0f;
@@ -162,11 +182,17 @@ static void ui_push_foundation(Vector* vec, World* world) {
                 },
         };
 
-        vec_push_back(vec, &ui_element);
+        ui_push_element(vec, lookup, &ui_element);
     }
 }
 
-static void ui_push_cascade(Vector* vec, World* world, int cascade_index, int x_offset) {
+static void ui_push_cascade(
+    Vector* vec,
+    UICardLookup* lookup,
+    World* world,
+    int cascade_index,
+    int x_offset
+) {
     Freecell* freecell = &world->game.freecell;
     Cascade* cascade = &freecell->cascade[cascade_index];
     Sprite* deck = world->deck;
@@ -180,7 +206,7 @@ static void ui_push_cascade(Vector* vec, World* world, int cascade_index, int x_
     none_card.y = none_card.height / 2.f + MARGIN_Y;
     none_card.z = 0.0f;
     none_card.color.a = 0.3f;
-    vec_push_back(vec, &(UIElement) {
+    ui_push_element(vec, lookup, &(UIElement) {
             .type = UI_CARD_PLACEHOLDER,
             .sprite = none_card,
             .hitbox = empty_hitbox(),
@@ -216,7 +242,7 @@ static void ui_push_cascade(Vector* vec, World* world, int cascade_index, int x_
             },
     };
 
-        vec_push_back(vec, &ui_element);
+        ui_push_element(vec, lookup, &ui_element);
     }
 
     for (int j = 0; j < cascade->size; j++) {
@@ -239,11 +265,11 @@ static void ui_push_cascade(Vector* vec, World* world, int cascade_index, int x_
             },
     };
 
-        vec_push_back(vec, &ui_element);
+        ui_push_element(vec, lookup, &ui_element);
     }
 }
 
-static void ui_push_cascades(Vector* vec, World* world) {
+static void ui_push_cascades(Vector* vec, UICardLookup* lookup, World* world) {
     Sprite* deck = world->deck;
 
     const int CASCADE_COUNT = 8;
@@ -253,18 +279,19 @@ static void ui_push_cascades(Vector* vec, World* world) {
     for (int i = 0; i < CASCADE_COUNT; i++) {
         int x_offset = (VIRTUAL_WIDTH - total_width) / 2.0f + i * (deck[NONE].width + GAP)
             + deck[NONE].width / 2.f;
-        ui_push_cascade(vec, world, i, x_offset);
+        ui_push_cascade(vec, lookup, world, i, x_offset);
     }
 }
 
-static APtr format_game_info(uint32_t seed, double seconds, uint32_t moves) {
+// Writes the game info into buf like snprintf, returning the length it needs
+static int format_game_info(char* buf, size_t size, uint32_t seed, double seconds, uint32_t moves) {
     int hrs = (int)(seconds / 3600);
     int mins = (int)((seconds - hrs * 3600) / 60);
     int secs = (int)(seconds) % 60;
 
-    int needed = snprintf(
-        NULL,
-        0,
+    return snprintf(
+        buf,
+        size,
         "# %u\n%s%02d:%02d:%02d\n%s%u",
         moves,
         ICON_CLOCK,
@@ -274,25 +301,19 @@ static APtr format_game_info(uint32_t seed, double seconds, uint32_t moves) {
         ICON_GAME,
         seed
     );
+}
+
+static APtr game_info_alloc(World* world) {
+    Game* game = &world->game;
+    int needed = format_game_info(NULL, 0, game->seed, game->clock, game->move_count);
     APtr buf = aalloc(needed + 1);
-    snprintf(
-        aptr(buf),
-        needed + 1,
-        "# %u\n%s%02d:%02d:%02d\n%s%u",
-        moves,
-        ICON_CLOCK,
-        hrs,
-        mins,
-        secs,
-        ICON_GAME,
-        seed
-    );
+    format_game_info(aptr(buf), needed + 1, game->seed, game->clock, game->move_count);
     return buf;
 }
 
 static void text_compute_size(
+    World* world,
     const char* text,
-    float glyph_width,
     float font_scaling,
     float line_height_scaling,
     float character_spacing_scaling,
@@ -301,37 +322,18 @@ static void text_compute_size(
 ) {
     // assumes font width and height are the same for all characters
     // this is true for the fonts used in this game
-    float font_size = glyph_width * font_scaling;
-
-    float char_spacing = font_size / 2.0f * character_spacing_scaling;
-    float line_height = font_size * line_height_scaling;
-
-    float offset_x = 0;
-
-    float max_width = 0;
-
-    size_t string_len = strlen(text);
-    uint32_t num_lines = string_len == 0 ? 0 : 1;
-    for (size_t i = 0; i < string_len; i++) {
-        uint8_t c = text[i];
-        if (c == '\n') {
-            offset_x = 0;
-            num_lines++;
-        } else if (c == '\t') {
-            // one tab should be equal to 4 spaces :P
-            offset_x += char_spacing * 4;
-        } else {
-            offset_x += char_spacing;
-        }
-        max_width = fmaxf(max_width, offset_x);
-    }
-
-    float max_height = num_lines * line_height;
+    TextStyle style = {
+        .glyph_size = world->characters[' '].height,
+        .font_scaling = font_scaling,
+        .line_height_scaling = line_height_scaling,
+        .character_spacing_scaling = character_spacing_scaling,
+    };
+    TextRun* run = text_cache_get(&world->text_cache, text, style);
 
     if (width)
-        *width = max_width;
+        *width = run->width;
     if (height)
-        *height = max_height;
+        *height = run->height;
 }
 
 static void ui_push_shortcuts(Vector* vec, World* world) {
@@ -348,8 +350,8 @@ static void ui_push_shortcuts(Vector* vec, World* world) {
 
     float width, height;
     text_compute_size(
+        world,
         aptr(shortcuts),
-        world->characters[' '].height,
         0.7f,
         1.0f,
         1.0f,
@@ -391,8 +393,8 @@ static void ui_push_instructions(Vector* vec, World* world) {
 
     float width, height;
     text_compute_size(
+        world,
         aptr(instructions),
-        world->characters[' '].height,
         0.75f,
         1.0f,
         1.0f,
@@ -423,12 +425,12 @@ static void ui_push_instructions(Vector* vec, World* world) {
 }
 
 static void ui_push_game_info(Vector* vec, World* world) {
-    APtr game_info = format_game_info(world->game.seed, world->game.clock, world->game.move_count);
+    APtr game_info = game_info_alloc(world);
 
     float width, height;
     text_compute_size(
+        world,
         aptr(game_info),
-        world->characters[' '].height,
         1.0f,
         1.3f,
         1.0f,
@@ -477,7 +479,7 @@ static void ui_push_game_over_text(Vector* vec, World* world) {
     strcpy(aptr(win), win_str);
 
     float width, height;
-    text_compute_size("You Won!", world->characters[' '].height, 2.0f, 1.0f, 1.0f, &width, &height);
+    text_compute_size(world, "You Won!", 2.0f, 1.0f, 1.0f, &width, &height);
     vec_push_back(vec, &(UIElement) {
             .type = UI_TEXT,
             .sprite = (Sprite) {
@@ -500,13 +502,16 @@ static void ui_push_game_over_text(Vector* vec, World* world) {
         });
 }
 
-static void ui_push_display(Vector* vec, World* world) {
+// Returns the index of the game info element
+static size_t ui_push_display(Vector* vec, World* world) {
     if (world->show_help) {
         ui_push_shortcuts(vec, world);
         ui_push_instructions(vec, world);
     }
+    size_t game_info_index = vec->size;
     ui_push_game_info(vec, world);
     ui_push_game_over_text(vec, world);
+    return game_info_index;
 }
 
 static void ui_push_buttons(Vector* vec, World* world) {
@@ -575,33 +580,46 @@ static void ui_push_buttons(Vector* vec, World* world) {
     });
 }
 
-void ui_push_world(Vector* vec, World* world) {
-    ui_push_display(vec, world);
+size_t ui_push_world(Vector* vec, UICardLookup* lookup, World* world) {
+    memset(lookup->element_index, -1, sizeof(lookup->element_index));
+
+    size_t game_info_index = ui_push_display(vec, world);
     ui_push_buttons(vec, world);
-    ui_push_freecells(vec, world);
-    ui_push_foundation(vec, world);
-    ui_push_cascades(vec, world);
+    ui_push_freecells(vec, lookup, world);
+    ui_push_foundation(vec, lookup, world);
+    ui_push_cascades(vec, lookup, world);
+    return game_info_index;
 }
 
-bool ui_get_topmost_hit(Vector* ui_elements, vec2s mouse, UIElement* topmost, size_t* index) {
-    if (ui_elements->size == 0) {
+bool ui_update_game_info(World* world, UIElement* game_info) {
+    Game* game = &world->game;
+    char text[128];
+    format_game_info(text, sizeof(text), game->seed, game->clock, game->move_count);
+
+    char* current = aptr(game_info->meta.text.text);
+    if (strcmp(text, current) == 0) {
         return false;
     }
 
-    for (int i = (int)ui_elements->size - 1; i >= 0; i--) {
-        vec_get_as(UIElement, ui_element, ui_elements, i);
-
-        if (point_in_rect(mouse.x, mouse.y, ui_element.hitbox)) {
-            if (index != NULL) {
-                *index = i;
-            }
+    // the text only grows when the hours gain a digit, otherwise it is rewritten in place
+    if (strlen(text) > strlen(current)) {
+        game_info->meta.text.text = aalloc(strlen(text) + 1);
+        current = aptr(game_info->meta.text.text);
+    }
+    strcpy(current, text);
+    return true;
+}
 
-            if (topmost != NULL) {
-                *topmost = ui_element;
-            }
-            return true;
-        }
+bool ui_get_topmost_hit(
+    World* world,
+    Vector* ui_elements,
+    vec2s mouse,
+    UIElement* topmost,
+    size_t* index
+) {
+    if (ui_elements->size == 0) {
+        return false;
     }
 
-    return false;
+    return ui_hit_grid_query(&world->ui_scene.hit_grid, ui_elements, mouse, topmost, index);
 }
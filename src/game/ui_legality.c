@@ -0,0 +1,95 @@
+#include "game/ui_legality.h"
+
+#include "game/game.h"
+#include "game/world.h"
+#include "utils.h"
+
+static void ui_legality_compute_movable(UILegalityCache* cache, Game* game) {
+    for (SelectionLocation location = 0; location < UI_LEGALITY_LOCATION_COUNT; location++) {
+        uint32_t mask = 0;
+        if (selection_location_is_cascade(location)) {
+            Cascade* cascade = &game->freecell.cascade[location - CASCADE_1];
+            for (uint32_t k = 0; k < cascade->size; k++) {
+                if (game_can_move_from(game, location, k)) {
+                    mask |= 1u << k;
+                }
+            }
+        } else if (game_can_move_from(game, location, 0)) {
+            // reserves and foundations hold a single card, the index is not used
+            mask = UINT32_MAX;
+        }
+        cache->movable_from[location] = mask;
+    }
+
+    cache->game_over = freecell_game_over(&game->freecell);
+    cache->trivially_solved = freecell_is_trivially_solved(&game->freecell);
+}
+
+static void ui_legality_compute_drop_targets(UILegalityCache* cache, Game* game) {
+    cache->drop_targets = 0;
+    if (!cache->dragging) {
+        return;
+    }
+
+    uint8_t size = freecell_count_cards_from_index(
+        &game->freecell,
+        cache->drag_location,
+        cache->drag_index
+    );
+
+    for (SelectionLocation location = 0; location < UI_LEGALITY_LOCATION_COUNT; location++) {
+        Move move = {
+            .from = cache->drag_location,
+            .to = location,
+            .size = size,
+        };
+        if (game_validate_move(game, move) == MOVE_SUCCESS) {
+            cache->drop_targets |= (uint16_t)(1u << location);
+        }
+    }
+}
+
+void ui_legality_update(UILegalityCache* cache, World* world) {
+    Game* game = &world->game;
+    UIDragState* drag_state = &world->controller.drag_state;
+
+    uint64_t position_hash = hash_bytes(&game->freecell, sizeof(Freecell));
+    bool position_changed = !cache->valid || cache->position_hash != position_hash;
+
+    bool drag_changed = position_changed || cache->dragging != drag_state->dragging
+        || (drag_state->dragging
+            && (cache->drag_location != drag_state->card_location
+                || cache->drag_index != drag_state->card_index));
+
+    if (position_changed) {
+        cache->position_hash = position_hash;
+        ui_legality_compute_movable(cache, game);
+    }
+
+    if (drag_changed) {
+        cache->dragging = drag_state->dragging;
+        cache->drag_location = drag_state->card_location;
+        cache->drag_index = drag_state->card_index;
+        ui_legality_compute_drop_targets(cache, game);
+    }
+
+    cache->valid = true;
+}
+
+bool ui_legality_can_move_from(
+    const UILegalityCache* cache,
+    SelectionLocation location,
+    uint32_t card_index
+) {
+    if (location >= UI_LEGALITY_LOCATION_COUNT || card_index >= 32) {
+        return false;
+    }
+    return (cache->movable_from[location] >> card_index) & 1u;
+}
+
+bool ui_legality_can_drop_on(const UILegalityCache* cache, SelectionLocation location) {
+    if (location >= UI_LEGALITY_LOCATION_COUNT) {
+        return false;
+    }
+    return (cache->drop_targets >> location) & 1u;
+}
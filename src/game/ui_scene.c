@@ -0,0 +1,203 @@
+#include <string.h>
+
+#include "game/ui_scene.h"
+
+#include "core/aalloc.h"
+#include "core/vector.h"
+
+#include "game/render_system.h"
+#include "game/ui_layout.h"
+#include "game/world.h"
+#include "rendering/renderer.h"
+
+UIScene ui_scene_init(void) {
+    UIScene scene = { 0 };
+    scene.layout = vec_init(sizeof(UIElement));
+    scene.slots = vec_init(sizeof(UISceneSlot));
+    scene.hit_grid = ui_hit_grid_init();
+    memset(scene.card_lookup.element_index, -1, sizeof(scene.card_lookup.element_index));
+    scene.layout_dirty = true;
+    scene.mesh = mesh_init();
+    scene.gpu_mesh = gpu_mesh_init();
+    scene.board_target = render_target_init();
+    scene.board_dirty = true;
+    scene.element_mesh = mesh_init();
+    return scene;
+}
+
+void ui_scene_free(UIScene* scene) {
+    vec_free(&scene->layout);
+    vec_free(&scene->slots);
+    ui_hit_grid_free(&scene->hit_grid);
+    mesh_free(&scene->mesh);
+    gpu_mesh_free(&scene->gpu_mesh);
+    render_target_free(&scene->board_target);
+    mesh_free(&scene->element_mesh);
+}
+
+static UILayoutKey ui_scene_layout_key(World* world) {
+    UILayoutKey key;
+    // keys are compared with memcmp, so padding has to be zeroed as well
+    memset(&key, 0, sizeof(key));
+    key.freecell = world->game.freecell;
+    if (world->controller.game_over_scheduled) {
+        memcpy(
+            key.game_over_foundation,
+            world->controller.game_over_foundation,
+            sizeof(key.game_over_foundation)
+        );
+    }
+    key.seed = world->game.seed;
+    key.move_count = world->game.move_count;
+    key.show_help = world->show_help;
+    key.sound_enabled = world->sound_enabled;
+    return key;
+}
+
+bool ui_scene_update_layout(UIScene* scene, World* world) {
+    UILayoutKey key = ui_scene_layout_key(world);
+    if (!scene->layout_dirty && memcmp(&key, &scene->layout_key, sizeof(key)) == 0) {
+        // the styled copy shares the text, so the slot has to be marked by hand
+        UIElement* game_info = vec_get(&scene->layout, scene->game_info_index);
+        if (ui_update_game_info(world, game_info)) {
+            UISceneSlot* slot = vec_get(&scene->slots, scene->game_info_index);
+            slot->dirty = true;
+        }
+        return false;
+    }
+    scene->layout_key = key;
+    scene->layout_dirty = true;
+
+    // Strings referenced by the layout live in the arena until the next layout
+    aclear();
+
+    scene->layout.size = 0;
+    scene->game_info_index = ui_push_world(&scene->layout, &scene->card_lookup, world);
+    ui_hit_grid_build(&scene->hit_grid, &scene->layout);
+
+    size_t count = scene->layout.size;
+    vec_ensure_capacity(&world->ui_elements, count);
+    memcpy(world->ui_elements.data, scene->layout.data, count * sizeof(UIElement));
+    world->ui_elements.size = count;
+
+    vec_ensure_capacity(&scene->slots, count);
+    memset(scene->slots.data, 0, count * sizeof(UISceneSlot));
+    scene->slots.size = count;
+
+    return true;
+}
+
+void ui_scene_sync_element(UIScene* scene, size_t index, const UIElement* element, bool hidden) {
+    UISceneSlot* slot = vec_get(&scene->slots, index);
+    if (hidden && slot->hidden) {
+        // collapsed either way, e.g. a dragged card moving every frame
+        return;
+    }
+    if (slot->hidden != hidden || memcmp(&slot->element, element, sizeof(UIElement)) != 0) {
+        slot->element = *element;
+        slot->hidden = hidden;
+        slot->dirty = true;
+    }
+}
+
+static void ui_scene_emit_slot(Mesh* mesh, World* world, UISceneSlot* slot) {
+    size_t first_vertex = mesh->vertices.size;
+    mesh_push_ui_element(mesh, world, &slot->element);
+
+    if (slot->hidden) {
+        // collapse every vertex onto the first one, degenerate triangles are never rasterized
+        Vertex* vertices = vec_get(&mesh->vertices, first_vertex);
+        for (size_t i = 1; i < mesh->vertices.size - first_vertex; i++) {
+            vertices[i].x = vertices[0].x;
+            vertices[i].y = vertices[0].y;
+        }
+    }
+}
+
+static void ui_scene_rebuild(UIScene* scene, World* world) {
+    mesh_clear(&scene->mesh);
+    for (size_t i = 0; i < scene->slots.size; i++) {
+        UISceneSlot* slot = vec_get(&scene->slots, i);
+        slot->first_vertex = (uint32_t)scene->mesh.vertices.size;
+        ui_scene_emit_slot(&scene->mesh, world, slot);
+        slot->vertex_count = (uint32_t)scene->mesh.vertices.size - slot->first_vertex;
+        slot->dirty = false;
+    }
+    gpu_mesh_upload(&scene->gpu_mesh, &scene->mesh);
+    scene->layout_dirty = false;
+    scene->board_dirty = true;
+}
+
+void ui_scene_upload(UIScene* scene, World* world) {
+    if (scene->layout_dirty) {
+        ui_scene_rebuild(scene, world);
+        return;
+    }
+
+    // Patch dirty slots on the CPU first, so that neighbouring slots can share one upload
+    bool has_dirty = false;
+    for (size_t i = 0; i < scene->slots.size; i++) {
+        UISceneSlot* slot = vec_get(&scene->slots, i);
+        if (!slot->dirty) {
+            continue;
+        }
+
+        mesh_clear(&scene->element_mesh);
+        ui_scene_emit_slot(&scene->element_mesh, world, slot);
+
+        if (scene->element_mesh.vertices.size != slot->vertex_count) {
+            // the element changed shape, the ranges after it are no longer valid
+            ui_scene_rebuild(scene, world);
+            return;
+        }
+
+        memcpy(
+            vec_get(&scene->mesh.vertices, slot->first_vertex),
+            scene->element_mesh.vertices.data,
+            slot->vertex_count * sizeof(Vertex)
+        );
+        has_dirty = true;
+    }
+
+    if (!has_dirty) {
+        return;
+    }
+
+    size_t run_start = 0;
+    size_t run_end = 0;
+    for (size_t i = 0; i <= scene->slots.size; i++) {
+        UISceneSlot* slot = i < scene->slots.size ? vec_get(&scene->slots, i) : NULL;
+        if (slot != NULL && slot->dirty) {
+            if (run_end == run_start) {
+                run_start = slot->first_vertex;
+            }
+            run_end = slot->first_vertex + slot->vertex_count;
+            slot->dirty = false;
+        } else if (run_end != run_start) {
+            gpu_mesh_upload_vertices(&scene->gpu_mesh, &scene->mesh, run_start, run_end - run_start);
+            run_start = run_end = 0;
+        }
+    }
+    scene->board_dirty = true;
+}
+
+void ui_scene_draw_board(UIScene* scene, World* world, int width, int height) {
+    if (render_target_resize(&scene->board_target, width, height)) {
+        scene->board_dirty = true;
+    }
+    if (!scene->board_dirty) {
+        return;
+    }
+
+    // creating the target binds its texture, the spritesheet has to be bound again
+    renderer_set_shader(world->assets.main_shader.program);
+    renderer_bind_texture(0, GL_TEXTURE_2D, world->assets.spritesheet_texture);
+
+    render_target_bind(&scene->board_target);
+    renderer_clear(BACKGROUND_COLOR);
+    // the board is blended like every queue layer
+    renderer_set_depth_write(false);
+    renderer_draw_mesh(&scene->gpu_mesh, GL_TRIANGLES);
+    render_target_unbind();
+    scene->board_dirty = false;
+}
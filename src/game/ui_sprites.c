@@ -3,44 +3,48 @@
 
 #include "rendering/sprite.h"
 
+#include "game/spritesheet_layout.h"
 #include "game/world.h"
+#include "rendering/texture_blob.h"
 
-// Spritesheet
+// Cards and buttons, packed into a padded and mipmapped atlas at build time by the asset baker
 const char MAIN_SPRITESHEET[] = {
-#embed "assets/spritesheet.png"
+#embed "spritesheet.bin"
 };
 
 const size_t MAIN_SPRITESHEET_SIZE = sizeof(MAIN_SPRITESHEET);
 
-const int WIDTH = 1856;
-const int HEIGHT = 724;
-
-// Card sprite properties
+static_assert(ATLAS_LEVEL_COUNT == 4, "the spritesheet size below sums four levels");
+static_assert(
+    sizeof(MAIN_SPRITESHEET)
+        == sizeof(TextureBlobHeader)
+            + (ATLAS_WIDTH * ATLAS_HEIGHT + (ATLAS_WIDTH / 2) * (ATLAS_HEIGHT / 2)
+               + (ATLAS_WIDTH / 4) * (ATLAS_HEIGHT / 4) + (ATLAS_WIDTH / 8) * (ATLAS_HEIGHT / 8))
+                * 4,
+    "spritesheet.bin doesn't match spritesheet_layout.h, rebuild the asset baker output"
+);
+
+// Card sprite properties are in spritesheet_layout.h
 const int CARD_ROW = 4;
 const int CARD_COL = 13;
 
-const int CARD_WIDTH = 127;
-const int CARD_HEIGHT = 180;
-
-const int CARD_GAP_X = 1;
-const int CARD_GAP_Y = 1;
-
 #ifdef __EMSCRIPTEN__
 const float CARD_SCALE = 0.68f;
 #else
 const float CARD_SCALE = 0.8f;
 #endif
 
-// Character sprite properties
-const int GLYPH_OFFSET_X = 13 * 128 + 1;
-const int GLYPH_OFFSET_Y = 1;
+// Character sprite properties are in spritesheet_layout.h, glyphs are read from the SDF atlas
+const char GLYPH_SDF_ATLAS[] = {
+#embed "glyph_sdf.bin"
+};
 
-const int GLYPH_COL = 6;
+const size_t GLYPH_SDF_ATLAS_SIZE = sizeof(GLYPH_SDF_ATLAS);
 
-const int GLYPH_WIDTH = 30;
-const int GLYPH_HEIGHT = 30;
-const int GLYPH_GAP_X = 2;
-const int GLYPH_GAP_Y = 2;
+static_assert(
+    sizeof(GLYPH_SDF_ATLAS) == sizeof(TextureBlobHeader) + GLYPH_SDF_WIDTH * GLYPH_SDF_HEIGHT,
+    "glyph_sdf.bin doesn't match spritesheet_layout.h, rebuild the asset baker output"
+);
 
 #ifdef __EMSCRIPTEN__
 const float GLYPH_SCALE = 0.8f;
@@ -51,20 +55,7 @@ const float GLYPH_SCALE = 1.0f;
 const char* ICON_GAME = "\x80 ";
 const char* ICON_CLOCK = "\x81 ";
 
-// Button sprite properties
-
-const int BUTTON_COL = 1;
-const int BUTTON_ROW = 3;
-
-const int BUTTON_WIDTH = 62;
-const int BUTTON_HEIGHT = 64;
-
-const int BUTTON_GAP_X = 1;
-const int BUTTON_GAP_Y = 1;
-
-const int BUTTON_OFFSET_X = (CARD_COL + 1) * (CARD_WIDTH + CARD_GAP_X) + 1;
-const int BUTTON_OFFSET_Y = HEIGHT - BUTTON_ROW * (BUTTON_HEIGHT + BUTTON_GAP_Y) + 1;
-
+// Button sprite properties are in spritesheet_layout.h
 const float BUTTON_SCALE = 0.8f;
 
 static Sprite get_card_sprite_at_idx(int row, int col) {
@@ -74,13 +65,16 @@ static Sprite get_card_sprite_at_idx(int row, int col) {
     sprite.color.b = 1.0f;
     sprite.color.a = 1.0f;
 
-    sprite.width = (float)CARD_WIDTH * CARD_SCALE;
-    sprite.height = (float)CARD_HEIGHT * CARD_SCALE;
+    sprite.width = (float)CARD_SHEET_WIDTH * CARD_SCALE;
+    sprite.height = (float)CARD_SHEET_HEIGHT * CARD_SCALE;
 
-    sprite.uv_top = 1.0f - row * (CARD_HEIGHT + CARD_GAP_Y) / (float)HEIGHT;
-    sprite.uv_bottom = sprite.uv_top - (float)CARD_HEIGHT / (float)HEIGHT;
-    sprite.uv_left = col * (CARD_WIDTH + CARD_GAP_X) / (float)WIDTH;
-    sprite.uv_right = sprite.uv_left + (float)CARD_WIDTH / (float)WIDTH;
+    // the quad covers the card without the padding of its atlas cell
+    float cell_y = row * ATLAS_CARD_CELL_HEIGHT + ATLAS_PADDING;
+    float cell_x = col * ATLAS_CARD_CELL_WIDTH + ATLAS_PADDING;
+    sprite.uv_top = 1.0f - cell_y / (float)ATLAS_HEIGHT;
+    sprite.uv_bottom = sprite.uv_top - (float)CARD_SHEET_HEIGHT / (float)ATLAS_HEIGHT;
+    sprite.uv_left = cell_x / (float)ATLAS_WIDTH;
+    sprite.uv_right = sprite.uv_left + (float)CARD_SHEET_WIDTH / (float)ATLAS_WIDTH;
 
     return sprite;
 }
@@ -95,10 +89,14 @@ static Sprite get_glyph_sprite_at_idx(int row, int col) {
     sprite.width = (float)GLYPH_WIDTH * GLYPH_SCALE;
     sprite.height = (float)GLYPH_HEIGHT * GLYPH_SCALE;
 
-    sprite.uv_top = 1.0f - (GLYPH_OFFSET_Y + row * (GLYPH_HEIGHT + GLYPH_GAP_Y)) / (float)HEIGHT;
-    sprite.uv_bottom = sprite.uv_top - (float)GLYPH_HEIGHT / (float)HEIGHT;
-    sprite.uv_left = (GLYPH_OFFSET_X + col * (GLYPH_WIDTH + GLYPH_GAP_X)) / (float)WIDTH;
-    sprite.uv_right = sprite.uv_left + (float)GLYPH_WIDTH / (float)WIDTH;
+    // the quad covers the glyph cell without its padding
+    // the baker stores rows bottom up, like the spritesheet after its vertical flip
+    float cell_y = row * GLYPH_SDF_CELL_HEIGHT + GLYPH_SDF_PADDING;
+    float cell_x = col * GLYPH_SDF_CELL_WIDTH + GLYPH_SDF_PADDING;
+    sprite.uv_top = 1.0f - cell_y / (float)GLYPH_SDF_HEIGHT;
+    sprite.uv_bottom = sprite.uv_top - (float)GLYPH_HEIGHT / (float)GLYPH_SDF_HEIGHT;
+    sprite.uv_left = cell_x / (float)GLYPH_SDF_WIDTH;
+    sprite.uv_right = sprite.uv_left + (float)GLYPH_WIDTH / (float)GLYPH_SDF_WIDTH;
     return sprite;
 }
 
@@ -131,7 +129,7 @@ static void populate_glyph_sprites(World* world) {
     world->characters[' '] = sprite;
 
     // Sprites for all the non-extended printable ASCII characters
-    const int NUM_COLS = 6;
+    const int NUM_COLS = GLYPH_COL;
     for (size_t i = 0; i < sizeof(character_set) - 1; i++) {
         uint8_t c = character_set[i];
         int col = i % NUM_COLS;
@@ -151,13 +149,17 @@ static Sprite get_button_sprite_at_idx(int row, int col) {
     sprite.color.b = 1.0f;
     sprite.color.a = 1.0f;
 
-    sprite.width = (float)BUTTON_WIDTH * BUTTON_SCALE;
-    sprite.height = (float)BUTTON_HEIGHT * BUTTON_SCALE;
-
-    sprite.uv_top = 1.0f - (BUTTON_OFFSET_Y + row * (BUTTON_HEIGHT + BUTTON_GAP_Y)) / (float)HEIGHT;
-    sprite.uv_bottom = sprite.uv_top - (float)BUTTON_HEIGHT / (float)HEIGHT;
-    sprite.uv_left = (BUTTON_OFFSET_X + col * (BUTTON_WIDTH + BUTTON_GAP_X)) / (float)WIDTH;
-    sprite.uv_right = sprite.uv_left + (float)BUTTON_WIDTH / (float)WIDTH;
+    sprite.width = (float)BUTTON_SHEET_WIDTH * BUTTON_SCALE;
+    sprite.height = (float)BUTTON_SHEET_HEIGHT * BUTTON_SCALE;
+
+    // buttons are in the column right of the cards
+    float cell_y = row * ATLAS_BUTTON_CELL_HEIGHT + ATLAS_PADDING;
+    float cell_x = CARD_SHEET_COL * ATLAS_CARD_CELL_WIDTH + col * ATLAS_BUTTON_CELL_WIDTH
+        + ATLAS_PADDING;
+    sprite.uv_top = 1.0f - cell_y / (float)ATLAS_HEIGHT;
+    sprite.uv_bottom = sprite.uv_top - (float)BUTTON_SHEET_HEIGHT / (float)ATLAS_HEIGHT;
+    sprite.uv_left = cell_x / (float)ATLAS_WIDTH;
+    sprite.uv_right = sprite.uv_left + (float)BUTTON_SHEET_WIDTH / (float)ATLAS_WIDTH;
     return sprite;
 }
 
@@ -9,6 +9,7 @@
 #include "game/game.h"
 #include "game/ui_element.h"
 #include "game/ui_layout.h"
+#include "game/ui_legality.h"
 #include "game/ui_state.h"
 #include "game/world.h"
 #include "platform/window.h"
@@ -101,10 +102,12 @@ bool ui_is_element_draggable(World* world, UIElement* elem) {
     SelectionLocation loc = elem->meta.card.selection_location;
     uint32_t index = elem->meta.card.card_index;
 
-    return game_can_move_from(&world->game, loc, index);
+    // input can change the game between frames
+    ui_legality_update(&world->ui_legality, world);
+    return ui_legality_can_move_from(&world->ui_legality, loc, index);
 }
 
-bool ui_set_dragged_element_properties(UIElement* ui_element, World* world) {
+bool ui_is_element_dragged(World* world, const UIElement* ui_element) {
     UIDragState* drag_state = &world->controller.drag_state;
 
     // only card elements will have properties changed by drag
@@ -113,10 +116,27 @@ bool ui_set_dragged_element_properties(UIElement* ui_element, World* world) {
     }
 
     // Not being dragged or not the correct card
-    if (!drag_state->dragging
-        || drag_state->card_location != ui_element->meta.card.selection_location
-        || drag_state->card_index > ui_element->meta.card.card_index)
+    return drag_state->dragging
+        && drag_state->card_location == ui_element->meta.card.selection_location
+        && drag_state->card_index <= ui_element->meta.card.card_index;
+}
+
+bool ui_is_element_highlighted(const UIElement* ui_element) {
+    if (ui_element->type == UI_CARD) {
+        return ui_element->meta.card.state != CARD_UI_STATE_NORMAL;
+    } else if (ui_element->type == UI_BUTTON) {
+        ButtonUIState state = ui_element->meta.button.state;
+        return state == BUTTON_UI_STATE_HOVERED || state == BUTTON_UI_STATE_SELECTED;
+    }
+    return false;
+}
+
+bool ui_set_dragged_element_properties(UIElement* ui_element, World* world) {
+    UIDragState* drag_state = &world->controller.drag_state;
+
+    if (!ui_is_element_dragged(world, ui_element)) {
         return false;
+    }
 
     vec2s mouse = world->controller.mouse;
 
@@ -136,33 +156,6 @@ bool ui_set_dragged_element_properties(UIElement* ui_element, World* world) {
     return true;
 }
 
-static bool can_card_be_moved_from(Game* game, SelectionLocation location, uint8_t card_index) {
-    return game_can_move_from(game, location, card_index);
-}
-
-static bool can_card_be_moved_to(
-    Game* game,
-    UIDragState* drag_state,
-    SelectionLocation location,
-    uint32_t card_index
-) {
-    if (!drag_state->dragging) {
-        return false;
-    }
-
-    Move move = {
-        .from = drag_state->card_location,
-        .to = location,
-        .size = freecell_count_cards_from_index(
-            &game->freecell,
-            drag_state->card_location,
-            drag_state->card_index
-        ),
-    };
-
-    return game_validate_move(game, move) == MOVE_SUCCESS;
-}
-
 UIElement ui_get_new_state(
     World* world,
     UIElement* element,
@@ -173,6 +166,7 @@ UIElement ui_get_new_state(
     UIElement new_element = *element;
     Game* game = &world->game;
     UIDragState* drag_state = &world->controller.drag_state;
+    UILegalityCache* legality = &world->ui_legality;
 
     bool is_dragged = ui_set_dragged_element_properties(&new_element, world);
 
@@ -189,9 +183,8 @@ UIElement ui_get_new_state(
         bool is_target
             = is_top_card && drag_state->dragging && drag_state->card_location != location;
 
-        bool can_move_to
-            = is_top_card && can_card_be_moved_to(game, drag_state, location, card_index);
-        bool can_move_from = can_card_be_moved_from(game, location, card_index);
+        bool can_move_to = is_top_card && ui_legality_can_drop_on(legality, location);
+        bool can_move_from = ui_legality_can_move_from(legality, location, card_index);
 
         new_element.meta.card.state = ui_card_state_transition(
             element->meta.card.state,
@@ -208,8 +201,8 @@ UIElement ui_get_new_state(
         // Undo button is disabled if no moves left
         // or if game over or potentially solved
         if (strcmp(id, "undo") == 0
-            && (world->game.history.size == 0 || freecell_game_over(&world->game.freecell)
-                || freecell_is_trivially_solved(&world->game.freecell))) {
+            && (world->game.history.size == 0 || legality->game_over
+                || legality->trivially_solved)) {
             disabled = true;
         }
 
@@ -223,19 +216,23 @@ UIElement ui_get_new_state(
 
 void ui_update_element_states(World* world) {
     Controller* controller = &world->controller;
+    Vector* layout = &world->ui_scene.layout;
     bool pressed = window_is_mouse_pressed(world->window, RGFW_mouseLeft);
 
+    // rules are only evaluated when the position or the drag source changed
+    ui_legality_update(&world->ui_legality, world);
+
     size_t hit_index = -1;
-    ui_get_topmost_hit(&world->ui_elements, controller->mouse, NULL, &hit_index);
+    ui_get_topmost_hit(world, layout, controller->mouse, NULL, &hit_index);
 
-    for (size_t i = 0; i < world->ui_elements.size; ++i) {
-        vec_get_as(UIElement, element, &world->ui_elements, i);
+    for (size_t i = 0; i < layout->size; ++i) {
+        UIElement* element = vec_get(layout, i);
 
         bool hovered = hit_index == i;
         bool clicked = hovered && pressed;
         bool disabled = false;
 
-        UIElement updated = ui_get_new_state(world, &element, hovered, clicked, disabled);
+        UIElement updated = ui_get_new_state(world, element, hovered, clicked, disabled);
         vec_set(&world->ui_elements, i, &updated);
     }
 }
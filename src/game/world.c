@@ -1,7 +1,5 @@
 #include "game/world.h"
 
-#include "core/log.h"
-
 #include "game/assets.h"
 #include "game/constants.h"
 #include "game/ui_sprites.h"
@@ -13,7 +11,12 @@ World world_init(RGFW_window* window) {
     World world = { 0 };
     world.window = window;
     world.game = game_init();
+
+    profiler_startup_begin(PROFILER_STARTUP_ASSETS);
     world.assets = assets_init();
+    profiler_startup_end(PROFILER_STARTUP_ASSETS);
+
+    profiler_startup_begin(PROFILER_STARTUP_WORLD);
 
     Camera camera = {
         .view = GLM_MAT4_IDENTITY_INIT,
@@ -30,52 +33,29 @@ World world_init(RGFW_window* window) {
     );
 
     world.camera = camera;
+    world.camera_buffer = uniform_buffer_init(sizeof(Camera), UNIFORM_BINDING_CAMERA);
+    world_upload_camera(&world);
 
     populate_sprites(&world);
 
     world.ui_elements = vec_init(sizeof(UIElement));
+    world.ui_scene = ui_scene_init();
 
-    world.game_mesh = mesh_init();
-    world.game_gpu_mesh = gpu_mesh_init();
+    world.render_queue = render_queue_init();
 
     world.sound_enabled = true;
-    ma_result result = ma_engine_init(NULL, &world.engine);
-
-    if (result != MA_SUCCESS) {
-        log_error("Failed to initialize audio engine: %s", ma_result_description(result));
-        exit(EXIT_FAILURE);
-    }
-
-    ma_decoder_config decoderConfig = ma_decoder_config_init(ma_format_f32, 0, 0);
-    result = ma_decoder_init_memory(
-        CARD_MOVE_SOUND,
-        CARD_MOVE_SOUND_SIZE,
-        &decoderConfig,
-        &world.card_move_decoder
-    );
-
-    if (result != MA_SUCCESS) {
-        log_error("Failed to initialize MP3 decoder: %s", ma_result_description(result));
-        exit(EXIT_FAILURE);
-    }
-
-    result = ma_sound_init_from_data_source(
-        &world.engine,
-        &world.card_move_decoder,
-        0,
-        NULL,
-        &world.card_move_sound
-    );
-
-    if (result != MA_SUCCESS) {
-        log_error("Failed to initialize sound from decoder: %s", ma_result_description(result));
-        ma_decoder_uninit(&world.card_move_decoder);
-        exit(EXIT_FAILURE);
-    }
+    // started after the first frame, see audio_start
+    audio_init(&world.audio);
 
     world.animation_system = animation_system_init();
+    world.timeline = timeline_init();
     world.show_help = true;
 
+    profiler_init(&world.profiler);
+    text_cache_init(&world.text_cache);
+    frame_scheduler_init(&world.frame_scheduler);
+    profiler_startup_end(PROFILER_STARTUP_WORLD);
+
     return world;
 }
 
@@ -84,14 +64,20 @@ void world_free(World* world) {
     assets_free(&world->assets);
 
     vec_free(&world->ui_elements);
+    ui_scene_free(&world->ui_scene);
 
-    gpu_mesh_free(&world->game_gpu_mesh);
-    mesh_free(&world->game_mesh);
-
-    ma_sound_uninit(&world->card_move_sound);
-    ma_decoder_uninit(&world->card_move_decoder);
+    render_queue_free(&world->render_queue);
+    uniform_buffer_free(&world->camera_buffer);
 
-    ma_engine_uninit(&world->engine);
+    audio_free(&world->audio);
 
     animation_system_free(&world->animation_system);
+    timeline_free(&world->timeline);
+
+    profiler_free(&world->profiler);
+    text_cache_free(&world->text_cache);
+}
+
+void world_upload_camera(World* world) {
+    uniform_buffer_update(&world->camera_buffer, &world->camera, sizeof(Camera));
 }
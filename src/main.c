@@ -5,7 +5,10 @@
 
 #include "rendering/renderer.h"
 
+#include "game/audio.h"
 #include "game/constants.h"
+#include "game/frame_scheduler.h"
+#include "game/profiler.h"
 #include "game/render_system.h"
 #include "game/world.h"
 #include "utils.h"
@@ -27,23 +30,51 @@ void gameloop(RGFW_window* window) {
     window_get_size(window, &width, &height);
     controller_on_framebuffer_resize(&world, width, height);
 
+    // the first frame is drawn without waiting for anything
+    world.controller.screen_needs_update = true;
+    bool first_frame = true;
+    profiler_startup_begin(PROFILER_STARTUP_FIRST_FRAME);
+
     double time = time_millis_from_start() / 1000.0;
     while (!window_is_queued_to_close(window)) {
-        window_swap_buffers(window);
-        if (!world.controller.screen_needs_update) {
-            event_wait_timeout(1000 / 5.0);
+        if (!frame_scheduler_wait(&world.frame_scheduler, &world)) {
+            // minimized, keep the event queue drained without drawing anything
+            controller_handle_inputs(&world);
+            continue;
         }
+
         double dt = time_millis_from_start() / 1000.0 - time;
-        controller_update(&world, dt);
         time = time_millis_from_start() / 1000.0;
 
-        aclear(); // Clear the arena allocator for the next frame
+        profiler_begin_frame(&world.profiler);
+        controller_update(&world, dt);
+
+        profiler_begin(&world.profiler, PROFILER_PHASE_SWAP);
+        window_swap_buffers(window);
+        profiler_end(&world.profiler, PROFILER_PHASE_SWAP);
+        profiler_end_frame(&world.profiler);
+
+        if (first_frame) {
+            first_frame = false;
+            profiler_startup_end(PROFILER_STARTUP_FIRST_FRAME);
+
+            // opening the audio device is the slowest part of startup, it waits until the
+            // game is on screen. The next frame waits for it, so startup ends here.
+            profiler_startup_begin(PROFILER_STARTUP_AUDIO);
+            audio_start(&world.audio);
+            profiler_startup_end(PROFILER_STARTUP_AUDIO);
+            profiler_startup_interactive();
+#ifdef FREECELL_DEBUG
+            profiler_startup_report();
+#endif
+        }
     }
     afree(); // Free the arena allocator at the end
     world_free(&world);
 }
 
 int main(void) {
+    profiler_startup_begin(PROFILER_STARTUP_WINDOW);
     RGFW_window* window = window_init((WindowConfig) {
         .width = VIRTUAL_WIDTH,
         .height = VIRTUAL_HEIGHT,
@@ -54,6 +85,7 @@ int main(void) {
         .title = GAME_TITLE,
         .vsync = true,
     });
+    profiler_startup_end(PROFILER_STARTUP_WINDOW);
 
     gameloop(window);
 
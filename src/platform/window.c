@@ -75,8 +75,12 @@ bool window_is_queued_to_close(RGFW_window* window) {
     return RGFW_window_shouldClose(window) == RGFW_TRUE;
 }
 
+bool window_is_minimized(RGFW_window* window) { return RGFW_window_isMinimized(window); }
+
 bool window_get_event(RGFW_window* window, RGFW_event* event) {
     return RGFW_window_checkEvent(window, event);
 }
 
 void event_wait_timeout(uint32_t waitMS) { RGFW_waitForEvent(waitMS); }
+
+void event_wait(void) { RGFW_waitForEvent(RGFW_eventWaitNext); }
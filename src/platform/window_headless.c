@@ -0,0 +1,169 @@
+#include <stdlib.h>
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include "core/log.h"
+#include "platform/window.h"
+#include "platform/window_headless.h"
+#include "rendering/render_target.h"
+
+#ifndef EGL_PLATFORM_SURFACELESS_MESA
+#define EGL_PLATFORM_SURFACELESS_MESA 0x31DD
+#endif
+
+// A GL context without a surface, everything is drawn into an offscreen render target instead.
+// Works on any EGL driver with surfaceless contexts, including Mesa's llvmpipe on CI machines.
+struct RGFW_window {
+    EGLDisplay display;
+    EGLContext context;
+    RenderTarget target;
+    bool should_close;
+};
+
+RGFW_window* window_init(WindowConfig config) {
+    RGFW_window* window = calloc(1, sizeof(RGFW_window));
+    if (!window) {
+        log_error("Failed to allocate the headless window\n");
+        exit(EXIT_FAILURE);
+    }
+
+    window->display =
+        eglGetPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+    if (window->display == EGL_NO_DISPLAY) {
+        window->display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
+    if (window->display == EGL_NO_DISPLAY || !eglInitialize(window->display, NULL, NULL)) {
+        log_error("Failed to initialize EGL: 0x%x\n", eglGetError());
+        exit(EXIT_FAILURE);
+    }
+
+    const EGLint config_attributes[] = {
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_SURFACE_TYPE,    EGL_PBUFFER_BIT,
+        EGL_RED_SIZE,        8,
+        EGL_GREEN_SIZE,      8,
+        EGL_BLUE_SIZE,       8,
+        EGL_ALPHA_SIZE,      8,
+        EGL_NONE,
+    };
+    EGLConfig egl_config;
+    EGLint config_count = 0;
+    if (!eglChooseConfig(window->display, config_attributes, &egl_config, 1, &config_count)
+        || config_count == 0) {
+        log_error("No EGL config supports desktop OpenGL\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // the same version the windowed build asks for
+    const EGLint context_attributes[] = {
+        EGL_CONTEXT_MAJOR_VERSION,       3,
+        EGL_CONTEXT_MINOR_VERSION,       3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE,
+    };
+    eglBindAPI(EGL_OPENGL_API);
+    window->context =
+        eglCreateContext(window->display, egl_config, EGL_NO_CONTEXT, context_attributes);
+    if (window->context == EGL_NO_CONTEXT
+        || !eglMakeCurrent(window->display, EGL_NO_SURFACE, EGL_NO_SURFACE, window->context)) {
+        log_error("Failed to create a surfaceless OpenGL context: 0x%x\n", eglGetError());
+        exit(EXIT_FAILURE);
+    }
+
+    if (!gladLoadGLLoader((GLADloadproc)eglGetProcAddress)) {
+        log_error("Failed to initialize GLAD.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // there is no framebuffer 0 without a surface, the target stands in for it
+    window->target = render_target_init();
+    render_target_resize(&window->target, (int)config.width, (int)config.height);
+    render_target_set_default_framebuffer(window->target.framebuffer);
+    render_target_unbind();
+
+    glViewport(0, 0, (int32_t)config.width, (int32_t)config.height);
+    return window;
+}
+
+void window_free(RGFW_window* window) {
+    render_target_set_default_framebuffer(0);
+    render_target_free(&window->target);
+    eglMakeCurrent(window->display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    eglDestroyContext(window->display, window->context);
+    eglTerminate(window->display);
+    free(window);
+}
+
+// Nothing is presented, waiting for the GPU keeps frame times comparable to a real swap
+void window_swap_buffers(RGFW_window* window) {
+    (void)window;
+    glFinish();
+}
+
+void window_get_size(RGFW_window* window, int* width, int* height) {
+    *width = window->target.width;
+    *height = window->target.height;
+}
+
+const char* window_get_clipboard(RGFW_window* window) {
+    (void)window;
+    return NULL;
+}
+
+void window_toggle_fullscreen(RGFW_window* window) { (void)window; }
+
+void window_maximize(RGFW_window* window) { (void)window; }
+
+// The cursor is kept off screen, so that nothing is hovered
+void window_get_cursor_position(RGFW_window* window, int* x, int* y) {
+    (void)window;
+    *x = -1;
+    *y = -1;
+}
+
+bool window_is_mouse_pressed(RGFW_window* window, uint8_t button) {
+    (void)window;
+    (void)button;
+    return false;
+}
+
+void window_queue_close(RGFW_window* window) { window->should_close = true; }
+
+bool window_is_queued_to_close(RGFW_window* window) { return window->should_close; }
+
+bool window_is_minimized(RGFW_window* window) {
+    (void)window;
+    return false;
+}
+
+bool window_get_event(RGFW_window* window, RGFW_event* event) {
+    (void)window;
+    (void)event;
+    return false;
+}
+
+void event_wait_timeout(uint32_t waitMS) { (void)waitMS; }
+
+void event_wait(void) { }
+
+void window_read_pixels(RGFW_window* window, uint8_t* rgba) {
+    int width = window->target.width;
+    int height = window->target.height;
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, window->target.framebuffer);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, rgba);
+
+    // GL returns the bottom row first
+    size_t stride = (size_t)width * 4;
+    for (int y = 0; y < height / 2; y++) {
+        uint8_t* top = rgba + (size_t)y * stride;
+        uint8_t* bottom = rgba + (size_t)(height - 1 - y) * stride;
+        for (size_t i = 0; i < stride; i++) {
+            uint8_t pixel = top[i];
+            top[i] = bottom[i];
+            bottom[i] = pixel;
+        }
+    }
+}
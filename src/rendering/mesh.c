@@ -1,8 +1,10 @@
 #define _USE_MATH_DEFINES
 #include <math.h>
 #include <stddef.h>
+#include <string.h>
 
 #include "rendering/mesh.h"
+#include "rendering/renderer.h"
 
 #ifndef __EMSCRIPTEN__
 #include <glad/glad.h>
@@ -10,6 +12,46 @@
 #include <GLES3/gl3.h>
 #endif
 
+static uint8_t unorm8(float value) {
+    if (!(value > 0.0f)) {
+        return 0;
+    }
+    return value >= 1.0f ? UINT8_MAX : (uint8_t)(value * UINT8_MAX + 0.5f);
+}
+
+static uint16_t unorm16(float value) {
+    if (!(value > 0.0f)) {
+        return 0;
+    }
+    return value >= 1.0f ? UINT16_MAX : (uint16_t)(value * UINT16_MAX + 0.5f);
+}
+
+void vertex_set_position(Vertex* vertex, float x, float y, float z) {
+    vertex->x = x;
+    vertex->y = y;
+    vertex->z = (int16_t)lrintf(z);
+}
+
+void vertex_set_color(Vertex* vertex, Color color) {
+    vertex->r = unorm8(color.r);
+    vertex->g = unorm8(color.g);
+    vertex->b = unorm8(color.b);
+    vertex->a = unorm8(color.a);
+}
+
+void vertex_set_tex_coords(Vertex* vertex, float u, float v) {
+    if (!isfinite(u) || !isfinite(v)) {
+        vertex->flags |= VERTEX_FLAG_UNTEXTURED;
+        vertex->u = 0;
+        vertex->v = 0;
+        return;
+    }
+
+    vertex->flags &= ~VERTEX_FLAG_UNTEXTURED;
+    vertex->u = unorm16(u);
+    vertex->v = unorm16(v);
+}
+
 Mesh mesh_init() {
     Mesh mesh;
     mesh.vertices = vec_init(sizeof(Vertex));
@@ -27,6 +69,31 @@ void mesh_free(Mesh* mesh) {
     vec_free(&mesh->indices);
 }
 
+void mesh_append(Mesh* mesh, const Mesh* src) {
+    size_t vertex_count = src->vertices.size;
+    size_t index_count = src->indices.size;
+    uint32_t base_index = (uint32_t)mesh->vertices.size;
+    if (vertex_count == 0) {
+        return;
+    }
+
+    vec_ensure_capacity(&mesh->vertices, mesh->vertices.size + vertex_count);
+    memcpy(
+        (Vertex*)mesh->vertices.data + mesh->vertices.size,
+        src->vertices.data,
+        vertex_count * sizeof(Vertex)
+    );
+    mesh->vertices.size += vertex_count;
+
+    vec_ensure_capacity(&mesh->indices, mesh->indices.size + index_count);
+    uint32_t* indices = (uint32_t*)mesh->indices.data + mesh->indices.size;
+    const uint32_t* src_indices = src->indices.data;
+    for (size_t i = 0; i < index_count; i++) {
+        indices[i] = base_index + src_indices[i];
+    }
+    mesh->indices.size += index_count;
+}
+
 void mesh_push_line(Mesh* mesh, Line line) {
     if (line.thickness <= 0.0f) {
         return;
@@ -61,25 +128,13 @@ void mesh_push_line(Mesh* mesh, Line line) {
 void mesh_push_triangle(Mesh* mesh, Triangle triangle) {
     Vertex vertices[3] = { 0 };
     for (int i = 0; i < sizeof(vertices) / sizeof(vertices[0]); i++) {
-        vertices[i].r = triangle.color.r;
-        vertices[i].g = triangle.color.g;
-        vertices[i].b = triangle.color.b;
-        vertices[i].a = triangle.color.a;
-        vertices[i].u = INFINITY;
-        vertices[i].v = INFINITY;
+        vertex_set_color(&vertices[i], triangle.color);
+        vertex_set_tex_coords(&vertices[i], INFINITY, INFINITY);
     }
 
-    vertices[0].x = triangle.x1;
-    vertices[0].y = triangle.y1;
-    vertices[0].z = triangle.z1;
-
-    vertices[1].x = triangle.x2;
-    vertices[1].y = triangle.y2;
-    vertices[1].z = triangle.z2;
-
-    vertices[2].x = triangle.x3;
-    vertices[2].y = triangle.y3;
-    vertices[2].z = triangle.z3;
+    vertex_set_position(&vertices[0], triangle.x1, triangle.y1, triangle.z1);
+    vertex_set_position(&vertices[1], triangle.x2, triangle.y2, triangle.z2);
+    vertex_set_position(&vertices[2], triangle.x3, triangle.y3, triangle.z3);
 
     uint32_t base_index = (uint32_t)mesh->vertices.size;
     uint32_t indices[] = {
@@ -121,23 +176,9 @@ void mesh_push_quad(Mesh* mesh, Quad quad) {
         float rx = lx * cosA - ly * sinA;
         float ry = lx * sinA + ly * cosA;
 
-        vertices[i].x = x + rx;
-        vertices[i].y = y + ry;
-        vertices[i].z = quad.z;
-
-        vertices[i].r = quad.color.r;
-        vertices[i].g = quad.color.g;
-        vertices[i].b = quad.color.b;
-        vertices[i].a = quad.color.a;
-        vertices[i].u = INFINITY;
-        vertices[i].v = INFINITY;
-    }
-
-    for (size_t i = 0; i < sizeof(vertices) / sizeof(vertices[0]); i++) {
-        vertices[i].r = quad.color.r;
-        vertices[i].g = quad.color.g;
-        vertices[i].b = quad.color.b;
-        vertices[i].a = quad.color.a;
+        vertex_set_position(&vertices[i], x + rx, y + ry, quad.z);
+        vertex_set_color(&vertices[i], quad.color);
+        vertex_set_tex_coords(&vertices[i], INFINITY, INFINITY);
     }
 
     uint32_t base_index = (uint32_t)mesh->vertices.size;
@@ -163,15 +204,9 @@ void mesh_push_ellipse(Mesh* mesh, Ellipse_ ellipse) {
     uint32_t base_index = (uint32_t)mesh->vertices.size;
 
     Vertex center_vertex = { 0 };
-    center_vertex.x = ellipse.x;
-    center_vertex.y = ellipse.y;
-    center_vertex.z = ellipse.z;
-    center_vertex.r = ellipse.color.r;
-    center_vertex.g = ellipse.color.g;
-    center_vertex.b = ellipse.color.b;
-    center_vertex.a = ellipse.color.a;
-    center_vertex.u = INFINITY;
-    center_vertex.v = INFINITY;
+    vertex_set_position(&center_vertex, ellipse.x, ellipse.y, ellipse.z);
+    vertex_set_color(&center_vertex, ellipse.color);
+    vertex_set_tex_coords(&center_vertex, INFINITY, INFINITY);
 
     vec_push_back(&mesh->vertices, &center_vertex);
 
@@ -238,34 +273,14 @@ void mesh_push_sprite(Mesh* mesh, Sprite sprite) {
         float rx = lx * cosA - ly * sinA;
         float ry = lx * sinA + ly * cosA;
 
-        vertices[i].x = x + rx;
-        vertices[i].y = y + ry;
-        vertices[i].z = sprite.z;
-
-        vertices[i].r = sprite.color.r;
-        vertices[i].g = sprite.color.g;
-        vertices[i].b = sprite.color.b;
-        vertices[i].a = sprite.color.a;
+        vertex_set_position(&vertices[i], x + rx, y + ry, sprite.z);
+        vertex_set_color(&vertices[i], sprite.color);
     }
 
-    for (size_t i = 0; i < sizeof(vertices) / sizeof(vertices[0]); i++) {
-        vertices[i].r = sprite.color.r;
-        vertices[i].g = sprite.color.g;
-        vertices[i].b = sprite.color.b;
-        vertices[i].a = sprite.color.a;
-    }
-
-    vertices[0].u = sprite.uv_right;
-    vertices[0].v = sprite.uv_top;
-
-    vertices[1].u = sprite.uv_right;
-    vertices[1].v = sprite.uv_bottom;
-
-    vertices[2].u = sprite.uv_left;
-    vertices[2].v = sprite.uv_bottom;
-
-    vertices[3].u = sprite.uv_left;
-    vertices[3].v = sprite.uv_top;
+    vertex_set_tex_coords(&vertices[0], sprite.uv_right, sprite.uv_top);
+    vertex_set_tex_coords(&vertices[1], sprite.uv_right, sprite.uv_bottom);
+    vertex_set_tex_coords(&vertices[2], sprite.uv_left, sprite.uv_bottom);
+    vertex_set_tex_coords(&vertices[3], sprite.uv_left, sprite.uv_top);
 
     uint32_t base_index = (uint32_t)mesh->vertices.size;
     uint32_t indices[] = {
@@ -282,76 +297,260 @@ void mesh_push_sprite(Mesh* mesh, Sprite sprite) {
     }
 }
 
+static void gpu_mesh_set_vertex_layout(void) {
+    size_t stride = sizeof(Vertex);
+
+    // Position (location = 0)
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(Vertex, x));
+    glEnableVertexAttribArray(0);
+
+    // Color (location = 1)
+    glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, (void*)offsetof(Vertex, r));
+    glEnableVertexAttribArray(1);
+
+    // TexCoords (location = 2)
+    glVertexAttribPointer(2, 2, GL_UNSIGNED_SHORT, GL_TRUE, stride, (void*)offsetof(Vertex, u));
+    glEnableVertexAttribArray(2);
+
+    // Depth (location = 3)
+    glVertexAttribPointer(3, 1, GL_SHORT, GL_FALSE, stride, (void*)offsetof(Vertex, z));
+    glEnableVertexAttribArray(3);
+
+    // Flags (location = 4)
+    glVertexAttribIPointer(4, 1, GL_UNSIGNED_SHORT, stride, (void*)offsetof(Vertex, flags));
+    glEnableVertexAttribArray(4);
+}
+
 GPUMesh gpu_mesh_init() {
-    GPUMesh mesh;
+    GPUMesh mesh = { 0 };
 
     glGenVertexArrays(1, &mesh.VAO);
     glGenBuffers(1, &mesh.VBO);
     glGenBuffers(1, &mesh.EBO);
     glBindVertexArray(mesh.VAO);
 
-    size_t stride = sizeof(Vertex);
-
     glBindBuffer(GL_ARRAY_BUFFER, mesh.VBO);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.EBO);
+    gpu_mesh_set_vertex_layout();
+    glBindVertexArray(0);
 
-    // Position (location = 0)
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(Vertex, x));
-    glEnableVertexAttribArray(0);
+    return mesh;
+}
 
-    // Color (location = 1)
-    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(Vertex, r));
-    glEnableVertexAttribArray(1);
+static bool gpu_mesh_supports_persistent_mapping(void) {
+#ifdef __EMSCRIPTEN__
+    // WebGL2 has neither buffer storage nor mapping
+    return false;
+#else
+    return GLAD_GL_VERSION_4_4 || GLAD_GL_ARB_buffer_storage;
+#endif
+}
 
-    // TexCoords (location = 2)
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(Vertex, u));
-    glEnableVertexAttribArray(2);
+#ifndef __EMSCRIPTEN__
+static void gpu_mesh_wait_section(GPUMesh* mesh, uint32_t section) {
+    GLsync fence = mesh->fences[section];
+    if (fence == NULL) {
+        return;
+    }
+
+    // The section was submitted two frames ago, so this normally returns immediately
+    GLenum status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+    while (status == GL_TIMEOUT_EXPIRED) {
+        status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+    }
+    glDeleteSync(fence);
+    mesh->fences[section] = NULL;
+}
+
+static void gpu_mesh_allocate_ring(
+    GPUMesh* mesh,
+    size_t section_vertex_capacity,
+    size_t section_index_capacity
+) {
+    for (uint32_t i = 0; i < GPU_MESH_RING_SECTIONS; i++) {
+        gpu_mesh_wait_section(mesh, i);
+    }
+
+    // Buffer storage is immutable, growing means recreating the buffers
+    glBindVertexArray(mesh->VAO);
+    if (mesh->mapped_vertices != NULL) {
+        glBindBuffer(GL_ARRAY_BUFFER, mesh->VBO);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->EBO);
+        glUnmapBuffer(GL_ELEMENT_ARRAY_BUFFER);
+    }
+    glDeleteBuffers(1, &mesh->VBO);
+    glDeleteBuffers(1, &mesh->EBO);
+    glGenBuffers(1, &mesh->VBO);
+    glGenBuffers(1, &mesh->EBO);
+
+    GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+    mesh->vertex_buffer_size = section_vertex_capacity * sizeof(Vertex) * GPU_MESH_RING_SECTIONS;
+    glBindBuffer(GL_ARRAY_BUFFER, mesh->VBO);
+    glBufferStorage(GL_ARRAY_BUFFER, mesh->vertex_buffer_size, NULL, flags);
+    mesh->mapped_vertices = glMapBufferRange(GL_ARRAY_BUFFER, 0, mesh->vertex_buffer_size, flags);
+
+    mesh->index_buffer_size = section_index_capacity * sizeof(uint32_t) * GPU_MESH_RING_SECTIONS;
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->EBO);
+    glBufferStorage(GL_ELEMENT_ARRAY_BUFFER, mesh->index_buffer_size, NULL, flags);
+    mesh->mapped_indices = glMapBufferRange(GL_ELEMENT_ARRAY_BUFFER, 0, mesh->index_buffer_size, flags);
+
+    gpu_mesh_set_vertex_layout();
     glBindVertexArray(0);
 
-    mesh.index_count = 0;
+    mesh->section_vertex_capacity = section_vertex_capacity;
+    mesh->section_index_capacity = section_index_capacity;
+    mesh->section = 0;
+}
+#endif
 
+GPUMesh gpu_mesh_init_streaming() {
+    GPUMesh mesh = gpu_mesh_init();
+#ifndef __EMSCRIPTEN__
+    if (gpu_mesh_supports_persistent_mapping()) {
+        mesh.streaming = true;
+        gpu_mesh_allocate_ring(&mesh, 4096, 6144);
+    }
+#endif
     return mesh;
 }
 
 void gpu_mesh_free(GPUMesh* mesh) {
+#ifndef __EMSCRIPTEN__
+    for (uint32_t i = 0; i < GPU_MESH_RING_SECTIONS; i++) {
+        if (mesh->fences[i] != NULL) {
+            glDeleteSync(mesh->fences[i]);
+            mesh->fences[i] = NULL;
+        }
+    }
+#endif
+    // deleting a buffer also unmaps it
     glDeleteBuffers(1, &mesh->VBO);
     glDeleteBuffers(1, &mesh->EBO);
     glDeleteVertexArrays(1, &mesh->VAO);
     mesh->VAO = mesh->VBO = mesh->EBO = 0;
     mesh->index_count = 0;
+    mesh->index_offset = 0;
+    mesh->mapped_vertices = mesh->mapped_indices = NULL;
+}
+
+static void gpu_mesh_count_upload(Mesh* mesh) {
+    renderer_stats.vertices_uploaded += (uint32_t)mesh->vertices.size;
+    renderer_stats.bytes_uploaded += mesh->vertices.size * mesh->vertices.elem_size
+        + mesh->indices.size * mesh->indices.elem_size;
+}
+
+#ifndef __EMSCRIPTEN__
+static void gpu_mesh_upload_streaming(GPUMesh* gpu_mesh, Mesh* mesh) {
+    if (mesh->vertices.size > gpu_mesh->section_vertex_capacity
+        || mesh->indices.size > gpu_mesh->section_index_capacity) {
+        size_t vertex_capacity = gpu_mesh->section_vertex_capacity;
+        size_t index_capacity = gpu_mesh->section_index_capacity;
+        while (vertex_capacity < mesh->vertices.size) {
+            vertex_capacity *= 2;
+        }
+        while (index_capacity < mesh->indices.size) {
+            index_capacity *= 2;
+        }
+        gpu_mesh_allocate_ring(gpu_mesh, vertex_capacity, index_capacity);
+    } else {
+        gpu_mesh->section = (gpu_mesh->section + 1) % GPU_MESH_RING_SECTIONS;
+    }
+
+    uint32_t section = gpu_mesh->section;
+    gpu_mesh_wait_section(gpu_mesh, section);
+
+    size_t first_vertex = section * gpu_mesh->section_vertex_capacity;
+    memcpy(
+        gpu_mesh->mapped_vertices + first_vertex * sizeof(Vertex),
+        mesh->vertices.data,
+        mesh->vertices.size * sizeof(Vertex)
+    );
+
+    // Indices are rebased onto the section, so no base vertex draw call is needed
+    size_t first_index = section * gpu_mesh->section_index_capacity;
+    uint32_t* indices = (uint32_t*)gpu_mesh->mapped_indices + first_index;
+    const uint32_t* source = mesh->indices.data;
+    for (size_t i = 0; i < mesh->indices.size; i++) {
+        indices[i] = source[i] + (uint32_t)first_vertex;
+    }
+
+    gpu_mesh->index_offset = first_index;
+    gpu_mesh->index_count = mesh->indices.size;
+    gpu_mesh_count_upload(mesh);
+}
+#endif
+
+// Reallocates the buffer only when the data outgrows it, otherwise it is updated in place
+static void gpu_buffer_upload(GLenum target, size_t* buffer_size, size_t size, const void* data) {
+    if (size > *buffer_size) {
+        *buffer_size = size;
+        glBufferData(target, size, data, GL_DYNAMIC_DRAW);
+        return;
+    }
+    glBufferSubData(target, 0, size, data);
 }
 
 void gpu_mesh_upload(GPUMesh* gpu_mesh, Mesh* mesh) {
+#ifndef __EMSCRIPTEN__
+    if (gpu_mesh->streaming) {
+        gpu_mesh_upload_streaming(gpu_mesh, mesh);
+        return;
+    }
+#endif
+
     glBindVertexArray(gpu_mesh->VAO);
     glBindBuffer(GL_ARRAY_BUFFER, gpu_mesh->VBO);
-    // glBufferData with NULL to orphan the buffer (for performance)
-    glBufferData(
+    gpu_buffer_upload(
         GL_ARRAY_BUFFER,
+        &gpu_mesh->vertex_buffer_size,
         mesh->vertices.size * mesh->vertices.elem_size,
-        NULL,
-        GL_DYNAMIC_DRAW
-    );
-    glBufferData(
-        GL_ARRAY_BUFFER,
-        mesh->vertices.size * mesh->vertices.elem_size,
-        mesh->vertices.data,
-        GL_DYNAMIC_DRAW
+        mesh->vertices.data
     );
 
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gpu_mesh->EBO);
-    // glBufferData with NULL to orphan the buffer (for performance)
-    glBufferData(
+    gpu_buffer_upload(
         GL_ELEMENT_ARRAY_BUFFER,
+        &gpu_mesh->index_buffer_size,
         mesh->indices.size * mesh->indices.elem_size,
-        NULL,
-        GL_DYNAMIC_DRAW
-    );
-    glBufferData(
-        GL_ELEMENT_ARRAY_BUFFER,
-        mesh->indices.size * mesh->indices.elem_size,
-        mesh->indices.data,
-        GL_DYNAMIC_DRAW
+        mesh->indices.data
     );
     glBindVertexArray(0);
+    gpu_mesh->index_offset = 0;
     gpu_mesh->index_count = mesh->indices.size;
+    gpu_mesh_count_upload(mesh);
+}
+
+void gpu_mesh_fence(GPUMesh* gpu_mesh) {
+#ifndef __EMSCRIPTEN__
+    if (!gpu_mesh->streaming) {
+        return;
+    }
+
+    uint32_t section = gpu_mesh->section;
+    if (gpu_mesh->fences[section] != NULL) {
+        glDeleteSync(gpu_mesh->fences[section]);
+    }
+    gpu_mesh->fences[section] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+#endif
+}
+
+void gpu_mesh_upload_vertices(
+    GPUMesh* gpu_mesh,
+    Mesh* mesh,
+    size_t first_vertex,
+    size_t vertex_count
+) {
+    renderer_stats.vertices_uploaded += (uint32_t)vertex_count;
+    renderer_stats.bytes_uploaded += vertex_count * mesh->vertices.elem_size;
+
+    glBindBuffer(GL_ARRAY_BUFFER, gpu_mesh->VBO);
+    glBufferSubData(
+        GL_ARRAY_BUFFER,
+        first_vertex * mesh->vertices.elem_size,
+        vertex_count * mesh->vertices.elem_size,
+        vec_get(&mesh->vertices, first_vertex)
+    );
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
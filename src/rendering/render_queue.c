@@ -0,0 +1,229 @@
+#include <string.h>
+
+#include "rendering/render_queue.h"
+
+#include "rendering/renderer.h"
+
+RenderQueue render_queue_init(void) {
+    RenderQueue queue = { 0 };
+    queue.items = vec_init(sizeof(RenderItem));
+    queue.sorted_items = vec_init(sizeof(RenderItem));
+    queue.mesh = mesh_init();
+    queue.batch_mesh = mesh_init();
+    queue.gpu_mesh = gpu_mesh_init_streaming();
+    return queue;
+}
+
+void render_queue_free(RenderQueue* queue) {
+    vec_free(&queue->items);
+    vec_free(&queue->sorted_items);
+    mesh_free(&queue->mesh);
+    mesh_free(&queue->batch_mesh);
+    gpu_mesh_free(&queue->gpu_mesh);
+}
+
+RenderKey render_key(RenderState state, uint16_t sequence) {
+    return ((RenderKey)state.layer << 56)
+        | ((RenderKey)(state.shader & 0xFFFF) << 40)
+        | ((RenderKey)(state.texture & 0xFFFF) << 24)
+        | ((RenderKey)(state.blend & 0xF) << 20)
+        | ((RenderKey)(state.primitive & 0xF) << 16)
+        | (RenderKey)sequence;
+}
+
+// Everything but the sequence, items with equal state keys can be drawn together
+static RenderKey render_key_state(RenderKey key) { return key >> 16; }
+
+Mesh* render_queue_mesh(RenderQueue* queue) { return &queue->mesh; }
+
+static void render_queue_push_item(RenderQueue* queue, RenderItem item, RenderState state) {
+    item.state = state;
+    item.key = render_key(state, (uint16_t)queue->items.size);
+    vec_push_back(&queue->items, &item);
+}
+
+void render_queue_submit(RenderQueue* queue, RenderState state) {
+    size_t index_count = queue->mesh.indices.size - queue->submitted_indices;
+    if (index_count == 0) {
+        return;
+    }
+
+    RenderItem item = {
+        .gpu_mesh = NULL,
+        .first_index = queue->submitted_indices,
+        .index_count = index_count,
+    };
+    render_queue_push_item(queue, item, state);
+    queue->submitted_indices = queue->mesh.indices.size;
+}
+
+void render_queue_push_mesh(RenderQueue* queue, GPUMesh* gpu_mesh, RenderState state) {
+    if (gpu_mesh->index_count == 0) {
+        return;
+    }
+
+    RenderItem item = {
+        .gpu_mesh = gpu_mesh,
+        .first_index = gpu_mesh->index_offset,
+        .index_count = gpu_mesh->index_count,
+    };
+    render_queue_push_item(queue, item, state);
+}
+
+// LSD radix sort on the 64 bit keys, one byte per pass.
+// Frames only use a handful of distinct states, so most passes are skipped.
+void render_queue_sort(RenderQueue* queue) {
+    size_t count = queue->items.size;
+    if (count == 0) {
+        return;
+    }
+    vec_ensure_capacity(&queue->sorted_items, count);
+    queue->sorted_items.size = count;
+
+    RenderItem* source = queue->items.data;
+    RenderItem* destination = queue->sorted_items.data;
+
+    for (uint32_t shift = 0; shift < 64; shift += 8) {
+        size_t offsets[256] = { 0 };
+        for (size_t i = 0; i < count; i++) {
+            offsets[(source[i].key >> shift) & 0xFF]++;
+        }
+
+        // all keys share this byte, the pass would not change the order
+        if (offsets[(source[0].key >> shift) & 0xFF] == count) {
+            continue;
+        }
+
+        size_t total = 0;
+        for (size_t i = 0; i < 256; i++) {
+            size_t bucket = offsets[i];
+            offsets[i] = total;
+            total += bucket;
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            destination[offsets[(source[i].key >> shift) & 0xFF]++] = source[i];
+        }
+
+        RenderItem* tmp = source;
+        source = destination;
+        destination = tmp;
+    }
+
+    // the result has to end up in items
+    if (source != queue->items.data) {
+        memcpy(queue->items.data, source, count * sizeof(RenderItem));
+    }
+}
+
+// Copies transient indices in sorted order, so that equal states end up adjacent
+static void render_queue_build_batches(RenderQueue* queue) {
+    Mesh* batch = &queue->batch_mesh;
+    mesh_clear(batch);
+
+    size_t vertex_count = queue->mesh.vertices.size;
+    vec_ensure_capacity(&batch->vertices, vertex_count);
+    memcpy(batch->vertices.data, queue->mesh.vertices.data, vertex_count * sizeof(Vertex));
+    batch->vertices.size = vertex_count;
+
+    vec_ensure_capacity(&batch->indices, queue->mesh.indices.size);
+    for (size_t i = 0; i < queue->items.size; i++) {
+        RenderItem* item = vec_get(&queue->items, i);
+        if (item->gpu_mesh != NULL) {
+            continue;
+        }
+
+        size_t first_index = batch->indices.size;
+        memcpy(
+            (uint32_t*)batch->indices.data + first_index,
+            vec_get(&queue->mesh.indices, item->first_index),
+            item->index_count * sizeof(uint32_t)
+        );
+        batch->indices.size += item->index_count;
+        item->first_index = first_index;
+    }
+}
+
+static void render_queue_apply_state(RenderState state, const RenderState* previous) {
+    if (previous == NULL || previous->shader != state.shader) {
+        renderer_set_shader(state.shader);
+    }
+    if (previous == NULL || previous->texture != state.texture) {
+        renderer_bind_texture(0, GL_TEXTURE_2D, state.texture);
+    }
+    if (previous == NULL || previous->blend != state.blend) {
+        if (state.blend == BLEND_NONE) {
+            glDisable(GL_BLEND);
+        } else {
+            glEnable(GL_BLEND);
+        }
+        renderer_set_depth_write(state.blend == BLEND_NONE);
+    }
+}
+
+void render_queue_flush(RenderQueue* queue) {
+    queue->draw_calls = 0;
+    if (queue->items.size == 0) {
+        mesh_clear(&queue->mesh);
+        queue->submitted_indices = 0;
+        return;
+    }
+
+    render_queue_sort(queue);
+    render_queue_build_batches(queue);
+
+    GPUMesh* stream = &queue->gpu_mesh;
+    bool has_transient = queue->batch_mesh.indices.size > 0;
+    if (has_transient) {
+        gpu_mesh_upload(stream, &queue->batch_mesh);
+    }
+    // indices of the current ring section start here
+    size_t stream_offset = stream->index_offset;
+
+    const RenderState* previous = NULL;
+    size_t count = queue->items.size;
+    for (size_t i = 0; i < count;) {
+        RenderItem* item = vec_get(&queue->items, i);
+        render_queue_apply_state(item->state, previous);
+        previous = &item->state;
+
+        if (item->gpu_mesh != NULL) {
+            renderer_draw_mesh_range(
+                item->gpu_mesh,
+                item->state.primitive,
+                item->first_index,
+                item->index_count
+            );
+            gpu_mesh_fence(item->gpu_mesh);
+            i++;
+        } else {
+            // following transient items with the same state have adjacent indices
+            size_t index_count = item->index_count;
+            size_t next = i + 1;
+            for (; next < count; next++) {
+                RenderItem* next_item = vec_get(&queue->items, next);
+                if (next_item->gpu_mesh != NULL
+                    || render_key_state(next_item->key) != render_key_state(item->key)) {
+                    break;
+                }
+                index_count += next_item->index_count;
+            }
+            renderer_draw_mesh_range(
+                stream,
+                item->state.primitive,
+                stream_offset + item->first_index,
+                index_count
+            );
+            i = next;
+        }
+        queue->draw_calls++;
+    }
+
+    if (has_transient) {
+        gpu_mesh_fence(stream);
+    }
+
+    queue->items.size = 0;
+    mesh_clear(&queue->mesh);
+    queue->submitted_indices = 0;
+}
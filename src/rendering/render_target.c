@@ -0,0 +1,107 @@
+#include <stdlib.h>
+
+#ifndef __EMSCRIPTEN__
+#include <glad/glad.h>
+#else
+#include <GLES3/gl3.h>
+#endif
+
+#include "rendering/render_target.h"
+
+#include "core/log.h"
+
+// the window's framebuffer, only an offscreen one when there is no window to draw to
+static uint32_t default_framebuffer = 0;
+
+RenderTarget render_target_init(void) { return (RenderTarget) { 0 }; }
+
+void render_target_set_default_framebuffer(uint32_t framebuffer) {
+    default_framebuffer = framebuffer;
+}
+
+void render_target_free(RenderTarget* target) {
+    if (target->framebuffer != 0) {
+        glDeleteFramebuffers(1, &target->framebuffer);
+        glDeleteTextures(1, &target->color);
+        glDeleteRenderbuffers(1, &target->depth);
+    }
+    *target = render_target_init();
+}
+
+bool render_target_resize(RenderTarget* target, int width, int height) {
+    if (target->framebuffer != 0 && target->width == width && target->height == height) {
+        return false;
+    }
+    render_target_free(target);
+    target->width = width;
+    target->height = height;
+
+    glGenTextures(1, &target->color);
+    glBindTexture(GL_TEXTURE_2D, target->color);
+    glTexImage2D(
+        GL_TEXTURE_2D,
+        0,
+        GL_RGBA8,
+        width,
+        height,
+        0,
+        GL_RGBA,
+        GL_UNSIGNED_BYTE,
+        NULL
+    );
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    glGenRenderbuffers(1, &target->depth);
+    glBindRenderbuffer(GL_RENDERBUFFER, target->depth);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &target->framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, target->framebuffer);
+    glFramebufferTexture2D(
+        GL_FRAMEBUFFER,
+        GL_COLOR_ATTACHMENT0,
+        GL_TEXTURE_2D,
+        target->color,
+        0
+    );
+    glFramebufferRenderbuffer(
+        GL_FRAMEBUFFER,
+        GL_DEPTH_ATTACHMENT,
+        GL_RENDERBUFFER,
+        target->depth
+    );
+
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, default_framebuffer);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        log_error("Render target %dx%d is incomplete: 0x%x", width, height, status);
+        exit(EXIT_FAILURE);
+    }
+    return true;
+}
+
+void render_target_bind(RenderTarget* target) {
+    glBindFramebuffer(GL_FRAMEBUFFER, target->framebuffer);
+}
+
+void render_target_unbind(void) { glBindFramebuffer(GL_FRAMEBUFFER, default_framebuffer); }
+
+void render_target_blit_to_screen(RenderTarget* target) {
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, target->framebuffer);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, default_framebuffer);
+    glBlitFramebuffer(
+        0,
+        0,
+        target->width,
+        target->height,
+        0,
+        0,
+        target->width,
+        target->height,
+        GL_COLOR_BUFFER_BIT,
+        GL_NEAREST
+    );
+    glBindFramebuffer(GL_FRAMEBUFFER, default_framebuffer);
+}
@@ -1,6 +1,10 @@
 #include "rendering/renderer.h"
 #include "rendering/mesh.h"
 
+RendererStats renderer_stats = { 0 };
+
+void renderer_stats_reset() { renderer_stats = (RendererStats) { 0 }; }
+
 void renderer_init() {
     // Cull back faces
     glEnable(GL_CULL_FACE);
@@ -9,18 +13,26 @@ void renderer_init() {
     glEnable(GL_DEPTH_TEST);
     glDepthFunc(GL_LEQUAL);
 
-    // Enable blending
+    // Enable blending, colors are premultiplied by alpha
     glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
     glBlendColor(1.0f, 1.0f, 1.0f, 1.0f);
 }
 
 void renderer_clear(Color color) {
     glClearColor(color.r, color.g, color.b, color.a);
     glClear(GL_COLOR_BUFFER_BIT);
+    renderer_clear_depth();
+}
+
+void renderer_clear_depth() {
+    // the depth mask applies to clears as well
+    glDepthMask(GL_TRUE);
     glClear(GL_DEPTH_BUFFER_BIT);
 }
 
+void renderer_set_depth_write(bool enabled) { glDepthMask(enabled ? GL_TRUE : GL_FALSE); }
+
 void renderer_set_shader(uint32_t shader) { glUseProgram(shader); }
 
 void renderer_bind_texture(uint32_t slot, GLenum target, uint32_t texture) {
@@ -28,8 +40,26 @@ void renderer_bind_texture(uint32_t slot, GLenum target, uint32_t texture) {
     glBindTexture(target, texture);
 }
 
-void renderer_draw_mesh(GPUMesh* mesh, GLenum primitive) {
+void renderer_draw_mesh_range(
+    GPUMesh* mesh,
+    GLenum primitive,
+    size_t first_index,
+    size_t index_count
+) {
+    renderer_stats.draw_calls++;
+    renderer_stats.indices_drawn += (uint32_t)index_count;
+
     glBindVertexArray(mesh->VAO);
-    glDrawElements(primitive, (GLsizei)mesh->index_count, GL_UNSIGNED_INT, 0);
+    glDrawElements(
+        primitive,
+        (GLsizei)index_count,
+        GL_UNSIGNED_INT,
+        (void*)(first_index * sizeof(uint32_t))
+    );
     glBindVertexArray(0);
 }
+
+void renderer_draw_mesh(GPUMesh* mesh, GLenum primitive) {
+    renderer_draw_mesh_range(mesh, primitive, mesh->index_offset, mesh->index_count);
+    gpu_mesh_fence(mesh);
+}
@@ -1,4 +1,5 @@
 #include <stddef.h>
+#include <string.h>
 #ifndef __EMSCRIPTEN__
 #include <glad/glad.h>
 #else
@@ -7,9 +8,14 @@
 
 #include "rendering/shader.h"
 
+#include "rendering/shader_cache.h"
+
 #include "core/log.h"
 
-Shader shader_init(const char* vertex_shader_source, const char* fragment_shader_source) {
+static uint32_t shader_compile(
+    const char* vertex_shader_source,
+    const char* fragment_shader_source
+) {
     uint32_t vertexShader = glCreateShader(GL_VERTEX_SHADER);
     glShaderSource(vertexShader, 1, &vertex_shader_source, NULL);
     glCompileShader(vertexShader);
@@ -40,6 +46,11 @@ Shader shader_init(const char* vertex_shader_source, const char* fragment_shader
     uint32_t shaderProgram = glCreateProgram();
     glAttachShader(shaderProgram, vertexShader);
     glAttachShader(shaderProgram, fragmentShader);
+#ifndef __EMSCRIPTEN__
+    if (shader_cache_supported()) {
+        glProgramParameteri(shaderProgram, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+#endif
     glLinkProgram(shaderProgram);
 
     glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
@@ -58,19 +69,109 @@ Shader shader_init(const char* vertex_shader_source, const char* fragment_shader
     return shaderProgram;
 }
 
+// Fills the uniform table from the linked program
+static void shader_reflect(Shader* shader) {
+    GLint active_count = 0;
+    glGetProgramiv(shader->program, GL_ACTIVE_UNIFORMS, &active_count);
+
+    shader->uniform_count = 0;
+    for (GLint i = 0; i < active_count; i++) {
+        ShaderUniformInfo info = { 0 };
+        GLint size;
+        GLenum type;
+        glGetActiveUniform(
+            shader->program,
+            (GLuint)i,
+            sizeof(info.name),
+            NULL,
+            &size,
+            &type,
+            info.name
+        );
+
+        // members of uniform blocks have no location, they are set through their buffer
+        info.location = glGetUniformLocation(shader->program, info.name);
+        if (info.location < 0) {
+            continue;
+        }
+        if (shader->uniform_count == SHADER_MAX_UNIFORMS) {
+            log_error("More than %d uniforms, %s is ignored", SHADER_MAX_UNIFORMS, info.name);
+            continue;
+        }
+
+        // arrays are reported as name[0]
+        char* bracket = strchr(info.name, '[');
+        if (bracket != NULL) {
+            *bracket = '\0';
+        }
+        info.type = type;
+        shader->uniforms[shader->uniform_count++] = info;
+    }
+}
+
+int32_t shader_uniform_location(const Shader* shader, const char* name) {
+    for (size_t i = 0; i < shader->uniform_count; i++) {
+        if (strcmp(shader->uniforms[i].name, name) == 0) {
+            return shader->uniforms[i].location;
+        }
+    }
+    return -1;
+}
+
+bool shader_bind_uniform_block(const Shader* shader, const char* name, uint32_t binding) {
+    GLuint index = glGetUniformBlockIndex(shader->program, name);
+    if (index == GL_INVALID_INDEX) {
+        return false;
+    }
+    glUniformBlockBinding(shader->program, index, binding);
+    return true;
+}
+
+Shader shader_init(
+    const char* vertex_shader_source,
+    const char* fragment_shader_source,
+    const char* const* uniform_names,
+    size_t uniform_count
+) {
+    Shader shader = { 0 };
+    if (uniform_count > SHADER_MAX_UNIFORMS) {
+        log_error("%zu uniforms, at most %d are supported", uniform_count, SHADER_MAX_UNIFORMS);
+        return shader;
+    }
+
+    uint64_t key = shader_cache_key(vertex_shader_source, fragment_shader_source);
+    shader.program = shader_cache_load(key);
+    if (shader.program == 0) {
+        shader.program = shader_compile(vertex_shader_source, fragment_shader_source);
+        if (shader.program == 0) {
+            return shader;
+        }
+        shader_cache_store(shader.program, key);
+    }
+
+    shader_reflect(&shader);
+
+    // -1 for uniforms the compiler optimized out, glUniform ignores those
+    for (size_t i = 0; i < SHADER_MAX_UNIFORMS; i++) {
+        shader.uniform_locations[i]
+            = i < uniform_count ? shader_uniform_location(&shader, uniform_names[i]) : -1;
+    }
+    return shader;
+}
+
 void shader_free(Shader* shader) {
-    glDeleteProgram(*shader);
-    *shader = 0;
+    glDeleteProgram(shader->program);
+    shader->program = 0;
 }
 
-void shader_set_int(Shader shader, const char* name, int value) {
-    glUniform1i(glGetUniformLocation(shader, name), value);
+void shader_set_int(const Shader* shader, uint32_t uniform, int value) {
+    glUniform1i(shader->uniform_locations[uniform], value);
 }
 
-void shader_set_float(Shader shader, const char* name, float value) {
-    glUniform1f(glGetUniformLocation(shader, name), value);
+void shader_set_float(const Shader* shader, uint32_t uniform, float value) {
+    glUniform1f(shader->uniform_locations[uniform], value);
 }
 
-void shader_set_mat4(Shader shader, const char* name, const float* value) {
-    glUniformMatrix4fv(glGetUniformLocation(shader, name), 1, GL_FALSE, value);
+void shader_set_mat4(const Shader* shader, uint32_t uniform, const float* value) {
+    glUniformMatrix4fv(shader->uniform_locations[uniform], 1, GL_FALSE, value);
 }
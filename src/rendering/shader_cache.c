@@ -0,0 +1,193 @@
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <direct.h>
+#elif !defined(__EMSCRIPTEN__)
+#include <sys/stat.h>
+#endif
+
+#ifndef __EMSCRIPTEN__
+#include <glad/glad.h>
+#else
+#include <GLES3/gl3.h>
+#endif
+
+#include "rendering/shader_cache.h"
+
+#include "core/log.h"
+#include "utils.h"
+
+#define SHADER_CACHE_MAGIC 0x48534346u // "FCSH"
+
+typedef struct ShaderCacheHeader {
+    uint32_t magic;
+    uint32_t binary_format;
+    uint64_t key;
+    uint32_t length;
+} ShaderCacheHeader;
+
+uint64_t shader_cache_key(const char* vertex_shader_source, const char* fragment_shader_source) {
+    uint64_t key = hash_bytes(vertex_shader_source, strlen(vertex_shader_source)) * 31
+        + hash_bytes(fragment_shader_source, strlen(fragment_shader_source));
+    const GLenum strings[] = { GL_VENDOR, GL_RENDERER, GL_VERSION };
+    for (size_t i = 0; i < sizeof(strings) / sizeof(strings[0]); i++) {
+        const char* string = (const char*)glGetString(strings[i]);
+        if (string != NULL) {
+            key = key * 31 + hash_bytes(string, strlen(string));
+        }
+    }
+    return key;
+}
+
+bool shader_cache_supported(void) {
+#ifndef __EMSCRIPTEN__
+    if (!GLAD_GL_VERSION_4_1 && !GLAD_GL_ARB_get_program_binary) {
+        return false;
+    }
+    // some drivers expose the entry points without a single binary format
+    GLint format_count = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &format_count);
+    return format_count > 0;
+#else
+    return false;
+#endif
+}
+
+#ifndef __EMSCRIPTEN__
+// Creates a directory unless it already exists
+static bool shader_cache_make_directory(const char* path) {
+#if defined(_WIN32)
+    int result = _mkdir(path);
+#else
+    int result = mkdir(path, 0755);
+#endif
+    return result == 0 || errno == EEXIST;
+}
+
+/** The cache is a single file in a freecell directory of the per-user cache directory.
+ * A binary for other sources or another driver simply replaces it, the key tells them apart.
+ * With create, the directories are created if they are missing.
+ */
+static bool shader_cache_path(char* path, size_t size, bool create) {
+#if defined(_WIN32)
+    const char* directory = getenv("LOCALAPPDATA");
+    const char* suffix = "";
+#elif defined(__APPLE__)
+    const char* directory = getenv("HOME");
+    const char* suffix = "/Library/Caches";
+#else
+    const char* directory = getenv("XDG_CACHE_HOME");
+    const char* suffix = "";
+    if (directory == NULL || directory[0] == '\0') {
+        directory = getenv("HOME");
+        suffix = "/.cache";
+    }
+#endif
+    if (directory == NULL || directory[0] == '\0') {
+        return false;
+    }
+
+    // the user cache directory itself may not exist yet, e.g. ~/.cache on a fresh account
+    const char* parts[] = { "", "/freecell", "/freecell/program.bin" };
+    for (size_t i = 0; i < sizeof(parts) / sizeof(parts[0]); i++) {
+        int length = snprintf(path, size, "%s%s%s", directory, suffix, parts[i]);
+        if (length <= 0 || (size_t)length >= size) {
+            return false;
+        }
+        bool is_file = i == sizeof(parts) / sizeof(parts[0]) - 1;
+        if (create && !is_file && !shader_cache_make_directory(path)) {
+            return false;
+        }
+    }
+    return true;
+}
+#endif
+
+uint32_t shader_cache_load(uint64_t key) {
+#ifndef __EMSCRIPTEN__
+    char path[1024];
+    if (!shader_cache_supported() || !shader_cache_path(path, sizeof(path), false)) {
+        return 0;
+    }
+
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) {
+        return 0;
+    }
+
+    ShaderCacheHeader header;
+    void* binary = NULL;
+    bool ok = fread(&header, sizeof(header), 1, file) == 1 && header.magic == SHADER_CACHE_MAGIC
+        && header.key == key && header.length > 0;
+    if (ok) {
+        binary = malloc(header.length);
+        ok = binary != NULL && fread(binary, 1, header.length, file) == header.length;
+    }
+    fclose(file);
+
+    uint32_t program = 0;
+    if (ok) {
+        program = glCreateProgram();
+        glProgramBinary(program, header.binary_format, binary, (GLsizei)header.length);
+
+        // the driver may still reject a binary with a matching key, e.g. after an update
+        GLint success = 0;
+        glGetProgramiv(program, GL_LINK_STATUS, &success);
+        if (!success) {
+            glDeleteProgram(program);
+            program = 0;
+        }
+    }
+    free(binary);
+    return program;
+#else
+    (void)key;
+    return 0;
+#endif
+}
+
+void shader_cache_store(uint32_t program, uint64_t key) {
+#ifndef __EMSCRIPTEN__
+    char path[1024];
+    if (!shader_cache_supported() || !shader_cache_path(path, sizeof(path), true)) {
+        return;
+    }
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) {
+        return;
+    }
+
+    void* binary = malloc(length);
+    if (binary == NULL) {
+        return;
+    }
+
+    ShaderCacheHeader header = {
+        .magic = SHADER_CACHE_MAGIC,
+        .key = key,
+    };
+    GLsizei written = 0;
+    GLenum binary_format = 0;
+    glGetProgramBinary(program, length, &written, &binary_format, binary);
+    header.binary_format = binary_format;
+    header.length = (uint32_t)written;
+
+    FILE* file = fopen(path, "wb");
+    if (file == NULL || fwrite(&header, sizeof(header), 1, file) != 1
+        || fwrite(binary, 1, header.length, file) != header.length) {
+        log_error("Failed to write the shader cache %s", path);
+    }
+    if (file != NULL) {
+        fclose(file);
+    }
+    free(binary);
+#else
+    (void)program;
+    (void)key;
+#endif
+}
@@ -4,62 +4,73 @@
 #include <GLES3/gl3.h>
 #endif
 
+#include <string.h>
+
 #include "rendering/texture.h"
+#include "rendering/texture_blob.h"
 
 #include "core/log.h"
 
-uint32_t texture_init(Image* image) {
-    uint32_t texture;
-
-    GLenum internalFormat = GL_RGBA8;
-    GLenum format = GL_RGBA;
-
-    if (image->channels == 1) {
-        internalFormat = GL_R8;
-        format = GL_RED;
-    } else if (image->channels == 3) {
-        internalFormat = GL_RGB8;
-        format = GL_RGB;
-    } else if (image->channels == 4) {
-        internalFormat = GL_RGBA8;
-        format = GL_RGBA;
+static void texture_formats(int channels, GLenum* internal_format, GLenum* format) {
+    if (channels == 1) {
+        *internal_format = GL_R8;
+        *format = GL_RED;
+    } else if (channels == 3) {
+        *internal_format = GL_RGB8;
+        *format = GL_RGB;
+    } else if (channels == 4) {
+        *internal_format = GL_RGBA8;
+        *format = GL_RGBA;
     } else {
-        log_error("Unsupported image channel count: %d", image->channels);
+        log_error("Unsupported image channel count: %d", channels);
         exit(EXIT_FAILURE);
     }
+}
 
+// Creates and binds a texture with storage for every level
+static uint32_t texture_allocate(
+    int levels,
+    GLenum internal_format,
+    GLenum format,
+    int width,
+    int height
+) {
+    uint32_t texture;
     glGenTextures(1, &texture);
     glBindTexture(GL_TEXTURE_2D, texture);
 #ifdef __EMSCRIPTEN__
     // WebGL 2 guarantees TexStorage2D
-    glTexImage2D(
-        GL_TEXTURE_2D,
-        0,
-        internalFormat,
-        image->width,
-        image->height,
-        0,
-        format,
-        GL_UNSIGNED_BYTE,
-        NULL
-    );
+    glTexStorage2D(GL_TEXTURE_2D, levels, internal_format, width, height);
 #else
     if (GLAD_GL_ARB_texture_storage) {
-        glTexStorage2D(GL_TEXTURE_2D, 1, internalFormat, image->width, image->height);
+        glTexStorage2D(GL_TEXTURE_2D, levels, internal_format, width, height);
     } else {
-        glTexImage2D(
-            GL_TEXTURE_2D,
-            0,
-            internalFormat,
-            image->width,
-            image->height,
-            0,
-            format,
-            GL_UNSIGNED_BYTE,
-            NULL
-        );
+        for (int level = 0; level < levels; level++) {
+            glTexImage2D(
+                GL_TEXTURE_2D,
+                level,
+                internal_format,
+                width,
+                height,
+                0,
+                format,
+                GL_UNSIGNED_BYTE,
+                NULL
+            );
+            width = width > 1 ? width / 2 : 1;
+            height = height > 1 ? height / 2 : 1;
+        }
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1);
     }
 #endif
+    return texture;
+}
+
+uint32_t texture_init(Image* image) {
+    GLenum internalFormat, format;
+    texture_formats(image->channels, &internalFormat, &format);
+
+    uint32_t texture = texture_allocate(1, internalFormat, format, image->width, image->height);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexSubImage2D(
@@ -76,6 +87,60 @@ uint32_t texture_init(Image* image) {
     return texture;
 }
 
+uint32_t texture_init_from_blob(const uint8_t* blob, size_t size) {
+    TextureBlobHeader header;
+    if (size < sizeof(header)) {
+        log_error("Texture blob is too small: %zu bytes", size);
+        exit(EXIT_FAILURE);
+    }
+    // embedded blobs are only byte aligned
+    memcpy(&header, blob, sizeof(header));
+    if (header.magic != TEXTURE_BLOB_MAGIC || header.level_count == 0) {
+        log_error("Texture blob has an invalid header");
+        exit(EXIT_FAILURE);
+    }
+
+    GLenum internalFormat, format;
+    texture_formats((int)header.channels, &internalFormat, &format);
+
+    int width = (int)header.width;
+    int height = (int)header.height;
+    uint32_t texture
+        = texture_allocate((int)header.level_count, internalFormat, format, width, height);
+
+    // rows of the levels are tightly packed
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    size_t offset = sizeof(header);
+    for (uint32_t level = 0; level < header.level_count; level++) {
+        size_t level_size = (size_t)width * height * header.channels;
+        if (offset + level_size > size) {
+            log_error("Texture blob is truncated at level %u", level);
+            exit(EXIT_FAILURE);
+        }
+
+        glTexSubImage2D(
+            GL_TEXTURE_2D,
+            (GLint)level,
+            0,
+            0,
+            width,
+            height,
+            format,
+            GL_UNSIGNED_BYTE,
+            blob + offset
+        );
+        offset += level_size;
+        width = width > 1 ? width / 2 : 1;
+        height = height > 1 ? height / 2 : 1;
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    GLint min_filter = header.level_count > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR;
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, min_filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    return texture;
+}
+
 void texture_free(uint32_t* texture) {
     glDeleteTextures(1, texture);
     *texture = 0;
@@ -0,0 +1,34 @@
+#ifndef __EMSCRIPTEN__
+#include <glad/glad.h>
+#else
+#include <GLES3/gl3.h>
+#endif
+
+#include "rendering/uniform_buffer.h"
+
+#include "rendering/renderer.h"
+
+UniformBuffer uniform_buffer_init(size_t size, uint32_t binding) {
+    UniformBuffer uniform_buffer = {
+        .size = size,
+        .binding = binding,
+    };
+    glGenBuffers(1, &uniform_buffer.buffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, uniform_buffer.buffer);
+    glBufferData(GL_UNIFORM_BUFFER, (GLsizeiptr)size, NULL, GL_DYNAMIC_DRAW);
+    // the binding point keeps the buffer, no draw has to bind it again
+    glBindBufferBase(GL_UNIFORM_BUFFER, binding, uniform_buffer.buffer);
+    return uniform_buffer;
+}
+
+void uniform_buffer_free(UniformBuffer* uniform_buffer) {
+    glDeleteBuffers(1, &uniform_buffer->buffer);
+    uniform_buffer->buffer = 0;
+}
+
+void uniform_buffer_update(UniformBuffer* uniform_buffer, const void* data, size_t size) {
+    glBindBuffer(GL_UNIFORM_BUFFER, uniform_buffer->buffer);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, (GLsizeiptr)size, data);
+
+    renderer_stats.bytes_uploaded += size;
+}
@@ -1,8 +1,17 @@
 #include <assert.h>
+#include <math.h>
 #include <stdio.h>
 #include <string.h>
 
+#include "game/audio_queue.h"
+#include "game/constants.h"
 #include "game/freecell.h"
+#include "game/text_cache.h"
+#include "game/ui_hit_grid.h"
+#include "game/ui_legality.h"
+#include "game/world.h"
+#include "rendering/render_queue.h"
+#include "utils.h"
 
 void print_test_result(const char* test_name, bool passed) {
     printf("%s: %s\n", test_name, passed ? "PASS" : "FAIL");
@@ -458,6 +467,561 @@ void test_freecell_is_trivially_solved_false(void) {
     print_test_result("freecell_is_trivially_solved - invalid stacks", true);
 }
 
+void test_render_key_orders_by_layer_first(void) {
+    RenderState low = {
+        .layer = 0,
+        .shader = 0xFFFF,
+        .texture = 0xFFFF,
+        .blend = BLEND_ALPHA,
+        .primitive = GL_TRIANGLES,
+    };
+    RenderState high = { .layer = 1 };
+
+    assert(render_key(low, UINT16_MAX) < render_key(high, 0));
+    // the sequence only breaks ties between equal states
+    assert(render_key(low, 0) < render_key(low, 1));
+    assert((render_key(low, 7) & 0xFFFF) == 7);
+
+    print_test_result("test_render_key_orders_by_layer_first", true);
+}
+
+void test_render_queue_sort(void) {
+    RenderQueue queue = { 0 };
+    queue.items = vec_init(sizeof(RenderItem));
+    queue.sorted_items = vec_init(sizeof(RenderItem));
+
+    // enough items for the sequence to span both of its bytes
+    const uint16_t count = 600;
+    for (uint16_t i = 0; i < count; i++) {
+        RenderItem item = { 0 };
+        item.state.layer = (uint8_t)((i * 7) % 3);
+        item.state.texture = (i * 13) % 5;
+        item.key = render_key(item.state, i);
+        vec_push_back(&queue.items, &item);
+    }
+
+    render_queue_sort(&queue);
+
+    assert(queue.items.size == count);
+    RenderItem* items = queue.items.data;
+    uint32_t sequence_sum = 0;
+    for (uint16_t i = 0; i < count; i++) {
+        if (i > 0) {
+            assert(items[i - 1].key < items[i].key);
+        }
+        // the state travels with its key
+        assert(render_key(items[i].state, items[i].key & 0xFFFF) == items[i].key);
+        sequence_sum += items[i].key & 0xFFFF;
+    }
+    assert(sequence_sum == (uint32_t)count * (count - 1) / 2);
+
+    vec_free(&queue.items);
+    vec_free(&queue.sorted_items);
+
+    print_test_result("test_render_queue_sort", true);
+}
+
+void test_ui_legality_cache_hit(void) {
+    // the world is too large for the stack
+    static World world;
+    memset(&world, 0, sizeof(World));
+    world.game.freecell = freecell_init(1);
+
+    UILegalityCache cache = { 0 };
+    ui_legality_update(&cache, &world);
+    assert(cache.valid);
+    // only the top card of a full cascade can be picked up
+    assert(ui_legality_can_move_from(&cache, CASCADE_1, 6));
+    assert(!ui_legality_can_move_from(&cache, CASCADE_1, 0));
+    assert(!ui_legality_can_move_from(&cache, RESERVE_1, 0));
+
+    // nothing changed, so the cached answers are returned as they are
+    cache.movable_from[CASCADE_1] = 0;
+    ui_legality_update(&cache, &world);
+    assert(!ui_legality_can_move_from(&cache, CASCADE_1, 6));
+
+    print_test_result("test_ui_legality_cache_hit", true);
+}
+
+void test_ui_legality_invalidated_by_move(void) {
+    static World world;
+    memset(&world, 0, sizeof(World));
+    world.game.freecell = freecell_init(1);
+
+    UILegalityCache cache = { 0 };
+    ui_legality_update(&cache, &world);
+    cache.movable_from[CASCADE_1] = 0;
+
+    Move move = { .from = CASCADE_1, .to = RESERVE_1, .size = 1 };
+    assert(freecell_validate_move(&world.game.freecell, move) == MOVE_SUCCESS);
+    freecell_move(&world.game.freecell, move);
+
+    ui_legality_update(&cache, &world);
+    assert(ui_legality_can_move_from(&cache, CASCADE_1, 5));
+    assert(!ui_legality_can_move_from(&cache, CASCADE_1, 6));
+    assert(ui_legality_can_move_from(&cache, RESERVE_1, 0));
+
+    print_test_result("test_ui_legality_invalidated_by_move", true);
+}
+
+void test_ui_legality_invalidated_by_drag(void) {
+    static World world;
+    memset(&world, 0, sizeof(World));
+    world.game.freecell = freecell_init(1);
+
+    UILegalityCache cache = { 0 };
+    ui_legality_update(&cache, &world);
+    assert(!ui_legality_can_drop_on(&cache, RESERVE_1));
+
+    UIDragState* drag_state = &world.controller.drag_state;
+    drag_state->dragging = true;
+    drag_state->card_location = CASCADE_1;
+    drag_state->card_index = 6;
+    ui_legality_update(&cache, &world);
+    assert(ui_legality_can_drop_on(&cache, RESERVE_1));
+    assert(!ui_legality_can_drop_on(&cache, CASCADE_1));
+
+    // the same drag is a cache hit
+    cache.drop_targets = 0;
+    ui_legality_update(&cache, &world);
+    assert(!ui_legality_can_drop_on(&cache, RESERVE_1));
+
+    // a new drag source recomputes the drop targets, but not what can be moved
+    cache.movable_from[CASCADE_1] = 0;
+    drag_state->card_location = CASCADE_2;
+    ui_legality_update(&cache, &world);
+    assert(ui_legality_can_drop_on(&cache, RESERVE_1));
+    assert(!ui_legality_can_move_from(&cache, CASCADE_1, 6));
+
+    drag_state->dragging = false;
+    ui_legality_update(&cache, &world);
+    assert(!ui_legality_can_drop_on(&cache, RESERVE_1));
+
+    print_test_result("test_ui_legality_invalidated_by_drag", true);
+}
+
+// The topmost element is the last one drawn, so the reference scan walks backwards
+static bool find_topmost_linear(Vector* ui_elements, vec2s point, size_t* index) {
+    for (size_t i = ui_elements->size; i-- > 0;) {
+        UIElement* element = vec_get(ui_elements, i);
+        if (point_in_rect(point.x, point.y, element->hitbox)) {
+            *index = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+void test_ui_hit_grid_matches_linear_scan(void) {
+    Vector layout = vec_init(sizeof(UIElement));
+    uint32_t state = 12345;
+    for (int i = 0; i < 300; i++) {
+        UIElement element = { .type = UI_CARD };
+        state = state * 1103515245 + 12345;
+        element.hitbox.x = (float)(state >> 8 & 0xFFFF) / 0xFFFF * (VIRTUAL_WIDTH + 200) - 100;
+        state = state * 1103515245 + 12345;
+        element.hitbox.y = (float)(state >> 8 & 0xFFFF) / 0xFFFF * (VIRTUAL_HEIGHT + 200) - 100;
+        state = state * 1103515245 + 12345;
+        element.hitbox.width = 20.0f + (state >> 8 & 0xFF);
+        element.hitbox.height = 20.0f + (state >> 16 & 0xFF);
+        vec_push_back(&layout, &element);
+    }
+
+    UIHitGrid grid = ui_hit_grid_init();
+    ui_hit_grid_build(&grid, &layout);
+
+    for (float y = -50.0f; y < VIRTUAL_HEIGHT + 50.0f; y += 7.0f) {
+        for (float x = -50.0f; x < VIRTUAL_WIDTH + 50.0f; x += 7.0f) {
+            vec2s point = { { x, y } };
+            size_t expected = 0, found = 0;
+            bool expected_hit = find_topmost_linear(&layout, point, &expected);
+            bool hit = ui_hit_grid_query(&grid, &layout, point, NULL, &found);
+            assert(hit == expected_hit);
+            assert(!hit || found == expected);
+        }
+    }
+
+    ui_hit_grid_free(&grid);
+    vec_free(&layout);
+
+    print_test_result("test_ui_hit_grid_matches_linear_scan", true);
+}
+
+void test_ui_hit_grid_skips_lost_hitboxes(void) {
+    Vector layout = vec_init(sizeof(UIElement));
+    for (int i = 0; i < 3; i++) {
+        // stacked like a cascade, each card overlapping the one below
+        UIElement element = {
+            .type = UI_CARD,
+            .hitbox = { .x = 100.0f, .y = 100.0f + i * 20.0f, .width = 80.0f, .height = 120.0f },
+        };
+        vec_push_back(&layout, &element);
+    }
+
+    UIHitGrid grid = ui_hit_grid_init();
+    ui_hit_grid_build(&grid, &layout);
+
+    vec2s point = { { 100.0f, 130.0f } };
+    UIElement topmost;
+    size_t index = 0;
+    assert(ui_hit_grid_query(&grid, &layout, point, &topmost, &index));
+    assert(index == 2);
+    assert(topmost.hitbox.y == 140.0f);
+
+    // a dragged card keeps its cell entries but loses its hitbox
+    UIElement* dragged = vec_get(&layout, 2);
+    dragged->hitbox = (Rect) { 0 };
+    assert(ui_hit_grid_query(&grid, &layout, point, NULL, &index));
+    assert(index == 1);
+
+    ui_hit_grid_free(&grid);
+    vec_free(&layout);
+
+    print_test_result("test_ui_hit_grid_skips_lost_hitboxes", true);
+}
+
+static AnimationHandle push_test_animation(AnimationSystem* system, float duration) {
+    UIElementAnimation animation = {
+        .from = { .type = UI_CARD },
+        .to = { .type = UI_CARD },
+        .duration = duration,
+        .behaviour = ANIMATION_DELETE_ON_FINISH,
+    };
+    return animation_system_push(system, &animation);
+}
+
+void test_animation_handle_survives_swap_remove(void) {
+    AnimationSystem system = animation_system_init();
+    AnimationHandle first = push_test_animation(&system, 1.0f);
+    AnimationHandle second = push_test_animation(&system, 2.0f);
+    AnimationHandle third = push_test_animation(&system, 4.0f);
+
+    // the last animation moves into the hole left by the first
+    animation_system_cancel(&system, first);
+    assert(animation_system_count(&system) == 2);
+    assert(!animation_system_is_alive(&system, first));
+    assert(animation_system_is_alive(&system, second));
+    assert(animation_system_is_alive(&system, third));
+
+    Controller controller = { 0 };
+    animation_system_update(&system, &controller, 1.0f);
+    assert(animation_system_progress(&system, second) == 0.5f);
+    assert(animation_system_progress(&system, third) == 0.25f);
+
+    animation_system_free(&system);
+    print_test_result("test_animation_handle_survives_swap_remove", true);
+}
+
+void test_animation_stale_handle_after_slot_reuse(void) {
+    AnimationSystem system = animation_system_init();
+    AnimationHandle finished = push_test_animation(&system, 1.0f);
+    AnimationHandle running = push_test_animation(&system, 4.0f);
+
+    Controller controller = { 0 };
+    animation_system_update(&system, &controller, 2.0f);
+    assert(!animation_system_is_alive(&system, finished));
+    assert(animation_system_progress(&system, finished) == 1.0f);
+
+    // the new animation reuses the finished one's slot under a new generation
+    AnimationHandle reused = push_test_animation(&system, 8.0f);
+    assert(reused.slot == finished.slot);
+    assert(reused.generation != finished.generation);
+    assert(!animation_system_is_alive(&system, finished));
+
+    // the stale handle can't touch the animation now living in its slot
+    animation_system_cancel(&system, finished);
+    UIElement to = { .type = UI_CARD };
+    assert(!animation_system_retarget(&system, finished, &to, 1.0f));
+    assert(animation_system_count(&system) == 2);
+    assert(animation_system_is_alive(&system, reused));
+    assert(animation_system_is_alive(&system, running));
+    assert(animation_system_progress(&system, reused) == 0.0f);
+
+    animation_system_free(&system);
+    print_test_result("test_animation_stale_handle_after_slot_reuse", true);
+}
+
+static uint32_t fired_arguments[8];
+static size_t fired_count;
+static Timeline* scheduling_timeline;
+
+static void record_timeline_event(World* world, uint32_t argument) {
+    (void)world;
+    fired_arguments[fired_count++] = argument;
+}
+
+// Schedules a follow up event that is already due
+static void schedule_from_timeline_event(World* world, uint32_t argument) {
+    record_timeline_event(world, argument);
+    timeline_add_callback(scheduling_timeline, 0.0, record_timeline_event, argument + 1);
+}
+
+void test_timeline_fires_in_time_order(void) {
+    Timeline timeline = timeline_init();
+    fired_count = 0;
+
+    timeline_add_callback(&timeline, 3.0, record_timeline_event, 3);
+    timeline_add_callback(&timeline, 1.0, record_timeline_event, 1);
+    timeline_add_callback(&timeline, 2.0, record_timeline_event, 2);
+    // equal times fire in the order they were added
+    timeline_add_callback(&timeline, 1.0, record_timeline_event, 4);
+    assert(timeline_time_to_next_event(&timeline) == 1.0);
+
+    timeline_update(&timeline, NULL, 1.5);
+    assert(fired_count == 2);
+    assert(fired_arguments[0] == 1);
+    assert(fired_arguments[1] == 4);
+    assert(timeline_time_to_next_event(&timeline) == 0.5);
+
+    // added after the clock moved, so it is due at 2.5
+    timeline_add_callback(&timeline, 1.0, record_timeline_event, 5);
+
+    timeline_update(&timeline, NULL, 10.0);
+    assert(fired_count == 5);
+    assert(fired_arguments[2] == 2);
+    assert(fired_arguments[3] == 5);
+    assert(fired_arguments[4] == 3);
+    assert(isinf(timeline_time_to_next_event(&timeline)));
+    assert(timeline.time == 0.0);
+
+    timeline_free(&timeline);
+    print_test_result("test_timeline_fires_in_time_order", true);
+}
+
+void test_timeline_callback_schedules_event(void) {
+    Timeline timeline = timeline_init();
+    scheduling_timeline = &timeline;
+    fired_count = 0;
+
+    timeline_add_callback(&timeline, 1.0, schedule_from_timeline_event, 1);
+    timeline_add_callback(&timeline, 2.0, record_timeline_event, 3);
+
+    // the event scheduled by the first callback is due before the second one
+    timeline_update(&timeline, NULL, 1.0);
+    assert(fired_count == 2);
+    assert(fired_arguments[0] == 1);
+    assert(fired_arguments[1] == 2);
+
+    timeline_update(&timeline, NULL, 1.0);
+    assert(fired_count == 3);
+    assert(fired_arguments[2] == 3);
+
+    timeline_free(&timeline);
+    print_test_result("test_timeline_callback_schedules_event", true);
+}
+
+void test_timeline_stagger_delays_animations(void) {
+    AnimationSystem system = animation_system_init();
+    UIElementAnimation animations[3];
+    for (int i = 0; i < 3; i++) {
+        animations[i] = (UIElementAnimation) {
+            .from = { .type = UI_CARD },
+            .to = { .type = UI_CARD },
+            .duration = 1.0f,
+        };
+    }
+
+    // delayed animations wait in the animation system with a negative elapsed time
+    timeline_add_stagger(&system, 0.5, 0.25, animations, 3);
+    assert(animation_system_count(&system) == 3);
+    float* elapsed = system.elapsed.data;
+    assert(elapsed[0] == -0.5f);
+    assert(elapsed[1] == -0.75f);
+    assert(elapsed[2] == -1.0f);
+
+    animation_system_free(&system);
+    print_test_result("test_timeline_stagger_delays_animations", true);
+}
+
+static const TextStyle TEST_TEXT_STYLE = {
+    .glyph_size = 16.0f,
+    .font_scaling = 1.0f,
+    .line_height_scaling = 1.0f,
+    .character_spacing_scaling = 1.0f,
+};
+
+void test_text_cache_evicts_least_recently_used(void) {
+    TextCache cache;
+    text_cache_init(&cache);
+
+    TextRun* runs[TEXT_CACHE_RUN_COUNT];
+    char text[32];
+    for (int i = 0; i < TEXT_CACHE_RUN_COUNT; i++) {
+        snprintf(text, sizeof(text), "run %d", i);
+        runs[i] = text_cache_get(&cache, text, TEST_TEXT_STYLE);
+    }
+    assert(runs[0]->width == 5 * 8.0f);
+    assert(runs[0]->height == 16.0f);
+
+    // every run is in use, using the first one again leaves the second as the oldest
+    assert(text_cache_get(&cache, "run 0", TEST_TEXT_STYLE) == runs[0]);
+    TextRun* evicting = text_cache_get(&cache, "new run", TEST_TEXT_STYLE);
+    assert(evicting == runs[1]);
+    assert(strcmp(evicting->text.data, "new run") == 0);
+
+    assert(text_cache_get(&cache, "run 0", TEST_TEXT_STYLE) == runs[0]);
+    assert(text_cache_get(&cache, "run 2", TEST_TEXT_STYLE) == runs[2]);
+
+    // the evicted string comes back in the slot of the next oldest
+    assert(text_cache_get(&cache, "run 1", TEST_TEXT_STYLE) == runs[3]);
+
+    text_cache_free(&cache);
+    print_test_result("test_text_cache_evicts_least_recently_used", true);
+}
+
+void test_text_cache_compares_strings_on_key_match(void) {
+    TextCache cache;
+    text_cache_init(&cache);
+
+    TextRun* run = text_cache_get(&cache, "abc", TEST_TEXT_STYLE);
+    assert(text_cache_get(&cache, "abc", TEST_TEXT_STYLE) == run);
+
+    // stands in for a different string that hashes to the same key
+    ((char*)run->text.data)[2] = 'd';
+    TextRun* other = text_cache_get(&cache, "abc", TEST_TEXT_STYLE);
+    assert(other != run);
+    assert(strcmp(other->text.data, "abc") == 0);
+
+    TextStyle larger = TEST_TEXT_STYLE;
+    larger.font_scaling = 2.0f;
+    TextRun* scaled = text_cache_get(&cache, "abc", larger);
+    assert(scaled != other);
+    assert(scaled->width == 2.0f * other->width);
+
+    text_cache_free(&cache);
+    print_test_result("test_text_cache_compares_strings_on_key_match", true);
+}
+
+void test_text_layout_push_matches_cached_run(void) {
+    static Sprite characters[256];
+    TextPlacement placement = { .x = 10.0f, .y = 20.0f, .color = { 1.0f, 1.0f, 1.0f, 1.0f } };
+
+    TextCache cache;
+    text_cache_init(&cache);
+    Mesh cached = mesh_init();
+    text_cache_push(&cache, &cached, characters, "ab c\nd", TEST_TEXT_STYLE, placement);
+
+    // laid out behind a quad that isn't text, which has to keep its flags
+    Mesh direct = mesh_init();
+    mesh_push_sprite(&direct, characters['x']);
+    size_t first_vertex = direct.vertices.size;
+    text_layout_push(&direct, characters, "ab c\nd", TEST_TEXT_STYLE, placement);
+
+    assert(direct.vertices.size - first_vertex == cached.vertices.size);
+    Vertex* sprite_vertices = direct.vertices.data;
+    assert(!(sprite_vertices[0].flags & VERTEX_FLAG_SDF));
+    assert(
+        memcmp(
+            sprite_vertices + first_vertex,
+            cached.vertices.data,
+            cached.vertices.size * sizeof(Vertex)
+        )
+        == 0
+    );
+
+    mesh_free(&direct);
+    mesh_free(&cached);
+    text_cache_free(&cache);
+    print_test_result("test_text_layout_push_matches_cached_run", true);
+}
+
+void test_audio_queue_full_and_empty(void) {
+    static AudioQueue queue;
+    audio_queue_init(&queue);
+
+    AudioCommand command;
+    assert(!audio_queue_pop(&queue, &command));
+
+    for (uint32_t i = 0; i < AUDIO_QUEUE_CAPACITY; i++) {
+        assert(audio_queue_push(&queue, &(AudioCommand) { .sound = i }));
+    }
+    assert(!audio_queue_push(&queue, &(AudioCommand) { .sound = AUDIO_QUEUE_CAPACITY }));
+    assert(queue.dropped == 1);
+
+    for (uint32_t i = 0; i < AUDIO_QUEUE_CAPACITY; i++) {
+        assert(audio_queue_pop(&queue, &command));
+        assert(command.sound == i);
+    }
+    assert(!audio_queue_pop(&queue, &command));
+
+    print_test_result("test_audio_queue_full_and_empty", true);
+}
+
+void test_audio_queue_wraps_in_order(void) {
+    static AudioQueue queue;
+    audio_queue_init(&queue);
+
+    // start just before the indices overflow, so both the slot mask and the counters wrap
+    atomic_store(&queue.write_index, UINT32_MAX - 2);
+    atomic_store(&queue.read_index, UINT32_MAX - 2);
+
+    AudioCommand command;
+    uint32_t pushed = 0;
+    uint32_t popped = 0;
+    for (int round = 0; round < 3; round++) {
+        while (audio_queue_push(&queue, &(AudioCommand) { .sound = pushed })) {
+            pushed++;
+        }
+        assert(pushed - popped == AUDIO_QUEUE_CAPACITY);
+
+        // drain half, so the next round's pushes land across the end of the ring
+        for (uint32_t i = 0; i < AUDIO_QUEUE_CAPACITY / 2; i++) {
+            assert(audio_queue_pop(&queue, &command));
+            assert(command.sound == popped++);
+        }
+    }
+
+    while (audio_queue_pop(&queue, &command)) {
+        assert(command.sound == popped++);
+    }
+    assert(popped == pushed);
+    assert(atomic_load(&queue.read_index) == atomic_load(&queue.write_index));
+
+    print_test_result("test_audio_queue_wraps_in_order", true);
+}
+
+// Sums the ranks left on the foundations, every card taken off lowers it by one
+static int test_foundation_rank_sum(const Card* foundation) {
+    int sum = 0;
+    for (int i = 0; i < 4; i++) {
+        if (foundation[i] != NONE) {
+            sum += get_rank(foundation[i]) - ACE + 1;
+        }
+    }
+    return sum;
+}
+
+void test_game_over_sequence_keeps_game_won(void) {
+    static World world;
+    memset(&world, 0, sizeof(World));
+    world.animation_system = animation_system_init();
+    world.timeline = timeline_init();
+    world.ui_elements = vec_init(sizeof(UIElement));
+    world.game.freecell.foundation[SPADES] = KING_SPADES;
+    world.game.freecell.foundation[HEARTS] = KING_HEARTS;
+    world.game.freecell.foundation[DIAMONDS] = KING_DIAMONDS;
+    world.game.freecell.foundation[CLUBS] = KING_CLUBS;
+    world.game.clock = 42.0;
+
+    // a card leaves the foundations every 2 seconds
+    for (int i = 0; i < 5; i++) {
+        controller_step(&world, 2.0);
+        assert(world.controller.game_over_scheduled);
+        assert(!world.controller.autocomplete_scheduled);
+        assert(freecell_game_over(&world.game.freecell));
+        assert(world.game.clock == 42.0);
+    }
+
+    // the sequence drained its copy, the game itself still has every king
+    assert(test_foundation_rank_sum(world.controller.game_over_foundation) < 52);
+    assert(test_foundation_rank_sum(world.game.freecell.foundation) == 52);
+
+    vec_free(&world.ui_elements);
+    timeline_free(&world.timeline);
+    animation_system_free(&world.animation_system);
+    print_test_result("test_game_over_sequence_keeps_game_won", true);
+}
+
 int main(void) {
     test_freecell_push_and_pop_cascade();
     test_suits_differ_by_color();
@@ -490,6 +1054,32 @@ int main(void) {
     test_freecell_validate_move_invalid_size_zero();
     test_freecell_validate_move_invalid_same_source_dest();
 
+    test_render_key_orders_by_layer_first();
+    test_render_queue_sort();
+
+    test_ui_legality_cache_hit();
+    test_ui_legality_invalidated_by_move();
+    test_ui_legality_invalidated_by_drag();
+
+    test_ui_hit_grid_matches_linear_scan();
+    test_ui_hit_grid_skips_lost_hitboxes();
+
+    test_animation_handle_survives_swap_remove();
+    test_animation_stale_handle_after_slot_reuse();
+
+    test_timeline_fires_in_time_order();
+    test_timeline_callback_schedules_event();
+    test_timeline_stagger_delays_animations();
+
+    test_text_cache_evicts_least_recently_used();
+    test_text_cache_compares_strings_on_key_match();
+    test_text_layout_push_matches_cached_run();
+
+    test_audio_queue_full_and_empty();
+    test_audio_queue_wraps_in_order();
+
+    test_game_over_sequence_keeps_game_won();
+
     printf("All tests completed.\n");
     return 0;
 }
@@ -1,3 +1,4 @@
+#include <math.h>
 #include <stdint.h>
 #include <time.h>
 
@@ -22,6 +23,22 @@ uint64_t time_millis_from_start() {
     return time_millis() - time_start;
 }
 
+uint64_t time_micros() {
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+    return ((uint64_t)now.tv_sec * 1000000) + (now.tv_nsec / 1000);
+}
+
+uint64_t hash_bytes(const void* data, size_t size) {
+    const uint8_t* bytes = data;
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
 bool point_in_rect(float px, float py, Rect rect) {
     float halfW = rect.width / 2.0f;
     float halfH = rect.height / 2.0f;
@@ -30,6 +47,11 @@ bool point_in_rect(float px, float py, Rect rect) {
         && py <= rect.y + halfH;
 }
 
+bool rects_overlap(Rect a, Rect b) {
+    return fabsf(a.x - b.x) * 2.0f < a.width + b.width
+        && fabsf(a.y - b.y) * 2.0f < a.height + b.height;
+}
+
 vec2s screen_to_world(
     double mouse_x,
     double mouse_y,
@@ -101,5 +123,6 @@ float clamp(float value, float min, float max) {
 }
 
 float ease_in_out_cubic(float t) {
-    return t < 0.5f ? 4.0f * t * t * t : 1.0f - powf(-2.0f * t + 2.0f, 3.0f) / 2.0f;
+    float u = 1.0f - t;
+    return t < 0.5f ? 4.0f * t * t * t : 1.0f - 4.0f * u * u * u;
 }
@@ -0,0 +1,332 @@
+// Converts the spritesheet into GPU ready blobs at build time, see texture_blob.h.
+//
+// usage: asset_baker atlas <spritesheet.png> <output>
+//   writes the cards and buttons as a padded, premultiplied and mipmapped RGBA atlas,
+//   see spritesheet_layout.h
+// usage: asset_baker sdf <spritesheet.png> <output>
+//   writes the signed distance field of every glyph, see spritesheet_layout.h
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <stb_image.h>
+
+#include "game/spritesheet_layout.h"
+#include "rendering/texture_blob.h"
+
+// Coverage is resampled at this many samples per pixel and axis before measuring distances
+#define SDF_SUPERSAMPLING 4
+
+typedef struct Bitmap {
+    int width;
+    int height;
+    uint8_t* data;
+} Bitmap;
+
+static uint8_t* load_spritesheet(const char* path, int* width, int* height) {
+    int channels;
+    uint8_t* pixels = stbi_load(path, width, height, &channels, 4);
+    if (pixels == NULL) {
+        fprintf(stderr, "Failed to load %s: %s\n", path, stbi_failure_reason());
+        exit(EXIT_FAILURE);
+    }
+    if (*width != SPRITESHEET_WIDTH || *height != SPRITESHEET_HEIGHT) {
+        fprintf(
+            stderr,
+            "%s is %dx%d, spritesheet_layout.h expects %dx%d\n",
+            path,
+            *width,
+            *height,
+            SPRITESHEET_WIDTH,
+            SPRITESHEET_HEIGHT
+        );
+        exit(EXIT_FAILURE);
+    }
+    return pixels;
+}
+
+static uint8_t* load_alpha(const char* path, int* width, int* height) {
+    uint8_t* pixels = load_spritesheet(path, width, height);
+    uint8_t* alpha = malloc((size_t)*width * *height);
+    for (int i = 0; i < *width * *height; i++) {
+        alpha[i] = pixels[i * 4 + 3];
+    }
+    stbi_image_free(pixels);
+    return alpha;
+}
+
+// Bilinear alpha of the glyph at (x, y) in glyph pixels, transparent outside of the glyph
+static float glyph_alpha(const uint8_t* alpha, int sheet_width, int glyph_x, int glyph_y, float x,
+    float y) {
+    float fx = x - 0.5f;
+    float fy = y - 0.5f;
+    int x0 = (int)floorf(fx);
+    int y0 = (int)floorf(fy);
+    float tx = fx - x0;
+    float ty = fy - y0;
+
+    float samples[2][2];
+    for (int j = 0; j < 2; j++) {
+        for (int i = 0; i < 2; i++) {
+            int px = x0 + i;
+            int py = y0 + j;
+            bool inside = px >= 0 && py >= 0 && px < GLYPH_WIDTH && py < GLYPH_HEIGHT;
+            samples[j][i]
+                = inside ? alpha[(glyph_y + py) * sheet_width + glyph_x + px] / 255.0f : 0.0f;
+        }
+    }
+
+    float top = samples[0][0] + (samples[0][1] - samples[0][0]) * tx;
+    float bottom = samples[1][0] + (samples[1][1] - samples[1][0]) * tx;
+    return top + (bottom - top) * ty;
+}
+
+// Inside mask of a glyph, supersampled and with a margin of the padding plus the spread
+static Bitmap glyph_mask(const uint8_t* alpha, int sheet_width, int glyph_x, int glyph_y) {
+    int margin = GLYPH_SDF_PADDING + (int)ceilf(GLYPH_SDF_SPREAD);
+    Bitmap mask = {
+        .width = (GLYPH_WIDTH + 2 * margin) * SDF_SUPERSAMPLING,
+        .height = (GLYPH_HEIGHT + 2 * margin) * SDF_SUPERSAMPLING,
+    };
+    mask.data = malloc((size_t)mask.width * mask.height);
+
+    for (int y = 0; y < mask.height; y++) {
+        for (int x = 0; x < mask.width; x++) {
+            float gx = (x + 0.5f) / SDF_SUPERSAMPLING - margin;
+            float gy = (y + 0.5f) / SDF_SUPERSAMPLING - margin;
+            mask.data[y * mask.width + x]
+                = glyph_alpha(alpha, sheet_width, glyph_x, glyph_y, gx, gy) >= 0.5f;
+        }
+    }
+    return mask;
+}
+
+// Signed distance in glyph pixels from the sample to the nearest edge, positive inside
+static float mask_distance(const Bitmap* mask, int x, int y) {
+    bool inside = mask->data[y * mask->width + x];
+    int radius = (int)ceilf(GLYPH_SDF_SPREAD * SDF_SUPERSAMPLING);
+
+    int best = radius * radius + 1;
+    for (int dy = -radius; dy <= radius; dy++) {
+        int sy = y + dy;
+        if (sy < 0 || sy >= mask->height) {
+            continue;
+        }
+        for (int dx = -radius; dx <= radius; dx++) {
+            int sx = x + dx;
+            if (sx < 0 || sx >= mask->width) {
+                continue;
+            }
+            int distance = dx * dx + dy * dy;
+            if (distance < best && mask->data[sy * mask->width + sx] != inside) {
+                best = distance;
+            }
+        }
+    }
+
+    float distance = sqrtf((float)best) / SDF_SUPERSAMPLING;
+    return inside ? distance : -distance;
+}
+
+static void bake_glyph(uint8_t* atlas, const uint8_t* alpha, int sheet_width, int col, int row) {
+    int glyph_x = GLYPH_OFFSET_X + col * (GLYPH_WIDTH + GLYPH_GAP_X);
+    int glyph_y = GLYPH_OFFSET_Y + row * (GLYPH_HEIGHT + GLYPH_GAP_Y);
+    Bitmap mask = glyph_mask(alpha, sheet_width, glyph_x, glyph_y);
+
+    int margin = GLYPH_SDF_PADDING + (int)ceilf(GLYPH_SDF_SPREAD);
+    for (int y = 0; y < GLYPH_SDF_CELL_HEIGHT; y++) {
+        for (int x = 0; x < GLYPH_SDF_CELL_WIDTH; x++) {
+            // center of the atlas texel in the supersampled mask
+            int mx = (x - GLYPH_SDF_PADDING + margin) * SDF_SUPERSAMPLING + SDF_SUPERSAMPLING / 2;
+            int my = (y - GLYPH_SDF_PADDING + margin) * SDF_SUPERSAMPLING + SDF_SUPERSAMPLING / 2;
+
+            float value = 0.5f + mask_distance(&mask, mx, my) / (2.0f * GLYPH_SDF_SPREAD);
+            value = fminf(fmaxf(value, 0.0f), 1.0f);
+
+            // rows are stored bottom up, like the spritesheet after stbi's vertical flip
+            int atlas_x = col * GLYPH_SDF_CELL_WIDTH + x;
+            int atlas_y = GLYPH_SDF_HEIGHT - 1 - (row * GLYPH_SDF_CELL_HEIGHT + y);
+            atlas[atlas_y * GLYPH_SDF_WIDTH + atlas_x] = (uint8_t)lroundf(value * 255.0f);
+        }
+    }
+    free(mask.data);
+}
+
+// Writes a texture blob, levels holds every level back to back
+static void write_blob(const char* path, int width, int height, int channels, int level_count,
+    const uint8_t* levels, size_t size) {
+    TextureBlobHeader header = {
+        .magic = TEXTURE_BLOB_MAGIC,
+        .width = (uint32_t)width,
+        .height = (uint32_t)height,
+        .channels = (uint32_t)channels,
+        .level_count = (uint32_t)level_count,
+    };
+
+    FILE* file = fopen(path, "wb");
+    if (file == NULL || fwrite(&header, sizeof(header), 1, file) != 1
+        || fwrite(levels, 1, size, file) != size) {
+        fprintf(stderr, "Failed to write %s\n", path);
+        exit(EXIT_FAILURE);
+    }
+    fclose(file);
+}
+
+/** Copies a sprite into the middle of an atlas cell, with its border pixels repeated over the
+ * padding. Both positions are top down, the atlas is ATLAS_WIDTH pixels wide.
+ */
+static void pack_sprite(uint8_t* atlas, const uint8_t* sheet, int sheet_x, int sheet_y,
+    int width, int height, int cell_x, int cell_y, int cell_width, int cell_height) {
+    for (int y = 0; y < cell_height; y++) {
+        int source_y = y - ATLAS_PADDING;
+        source_y = source_y < 0 ? 0 : (source_y >= height ? height - 1 : source_y);
+        for (int x = 0; x < cell_width; x++) {
+            int source_x = x - ATLAS_PADDING;
+            source_x = source_x < 0 ? 0 : (source_x >= width ? width - 1 : source_x);
+
+            size_t source = (size_t)(sheet_y + source_y) * SPRITESHEET_WIDTH + sheet_x + source_x;
+            size_t destination = (size_t)(cell_y + y) * ATLAS_WIDTH + cell_x + x;
+            memcpy(atlas + destination * 4, sheet + source * 4, 4);
+        }
+    }
+}
+
+// Halves a premultiplied RGBA level with a box filter, odd edges are clamped
+static void downsample(const uint8_t* source, int width, int height, uint8_t* destination) {
+    int next_width = width > 1 ? width / 2 : 1;
+    int next_height = height > 1 ? height / 2 : 1;
+    for (int y = 0; y < next_height; y++) {
+        int y0 = y * 2;
+        int y1 = y0 + 1 < height ? y0 + 1 : y0;
+        for (int x = 0; x < next_width; x++) {
+            int x0 = x * 2;
+            int x1 = x0 + 1 < width ? x0 + 1 : x0;
+            for (int c = 0; c < 4; c++) {
+                int sum = source[((size_t)y0 * width + x0) * 4 + c]
+                    + source[((size_t)y0 * width + x1) * 4 + c]
+                    + source[((size_t)y1 * width + x0) * 4 + c]
+                    + source[((size_t)y1 * width + x1) * 4 + c];
+                destination[((size_t)y * next_width + x) * 4 + c] = (uint8_t)((sum + 2) / 4);
+            }
+        }
+    }
+}
+
+static void bake_atlas(const char* input, const char* output) {
+    int width, height;
+    uint8_t* sheet = load_spritesheet(input, &width, &height);
+
+    uint8_t* atlas = calloc((size_t)ATLAS_WIDTH * ATLAS_HEIGHT, 4);
+    for (int row = 0; row < CARD_SHEET_ROW; row++) {
+        for (int col = 0; col < CARD_SHEET_COL; col++) {
+            pack_sprite(
+                atlas,
+                sheet,
+                col * (CARD_SHEET_WIDTH + CARD_SHEET_GAP_X),
+                row * (CARD_SHEET_HEIGHT + CARD_SHEET_GAP_Y),
+                CARD_SHEET_WIDTH,
+                CARD_SHEET_HEIGHT,
+                col * ATLAS_CARD_CELL_WIDTH,
+                row * ATLAS_CARD_CELL_HEIGHT,
+                ATLAS_CARD_CELL_WIDTH,
+                ATLAS_CARD_CELL_HEIGHT
+            );
+        }
+    }
+    for (int row = 0; row < BUTTON_SHEET_ROW; row++) {
+        pack_sprite(
+            atlas,
+            sheet,
+            BUTTON_SHEET_OFFSET_X,
+            BUTTON_SHEET_OFFSET_Y + row * (BUTTON_SHEET_HEIGHT + BUTTON_SHEET_GAP_Y),
+            BUTTON_SHEET_WIDTH,
+            BUTTON_SHEET_HEIGHT,
+            CARD_SHEET_COL * ATLAS_CARD_CELL_WIDTH,
+            row * ATLAS_BUTTON_CELL_HEIGHT,
+            ATLAS_BUTTON_CELL_WIDTH,
+            ATLAS_BUTTON_CELL_HEIGHT
+        );
+    }
+    stbi_image_free(sheet);
+
+    size_t total_size = 0;
+    for (int level = 0; level < ATLAS_LEVEL_COUNT; level++) {
+        int level_width = ATLAS_WIDTH >> level;
+        int level_height = ATLAS_HEIGHT >> level;
+        total_size += (size_t)(level_width > 1 ? level_width : 1)
+            * (level_height > 1 ? level_height : 1) * 4;
+    }
+    uint8_t* levels = malloc(total_size);
+
+    // premultiply, so filtering never pulls in the color of transparent pixels,
+    // and flip, the game addresses the atlas bottom up like GL textures
+    size_t row_size = (size_t)ATLAS_WIDTH * 4;
+    for (int y = 0; y < ATLAS_HEIGHT; y++) {
+        const uint8_t* source = atlas + y * row_size;
+        uint8_t* destination = levels + (ATLAS_HEIGHT - 1 - y) * row_size;
+        for (int x = 0; x < ATLAS_WIDTH; x++) {
+            uint8_t alpha = source[x * 4 + 3];
+            for (int c = 0; c < 3; c++) {
+                destination[x * 4 + c] = (uint8_t)((source[x * 4 + c] * alpha + 127) / 255);
+            }
+            destination[x * 4 + 3] = alpha;
+        }
+    }
+    free(atlas);
+
+    uint8_t* level = levels;
+    int level_width = ATLAS_WIDTH;
+    int level_height = ATLAS_HEIGHT;
+    for (int i = 1; i < ATLAS_LEVEL_COUNT; i++) {
+        uint8_t* next = level + (size_t)level_width * level_height * 4;
+        downsample(level, level_width, level_height, next);
+        level = next;
+        level_width = level_width > 1 ? level_width / 2 : 1;
+        level_height = level_height > 1 ? level_height / 2 : 1;
+    }
+
+    write_blob(output, ATLAS_WIDTH, ATLAS_HEIGHT, 4, ATLAS_LEVEL_COUNT, levels, total_size);
+    free(levels);
+}
+
+static void bake_sdf(const char* input, const char* output) {
+    int width, height;
+    uint8_t* alpha = load_alpha(input, &width, &height);
+
+    uint8_t* atlas = calloc(GLYPH_SDF_WIDTH * GLYPH_SDF_HEIGHT, 1);
+    for (int row = 0; row < GLYPH_ROW; row++) {
+        for (int col = 0; col < GLYPH_COL; col++) {
+            bake_glyph(atlas, alpha, width, col, row);
+        }
+    }
+
+    write_blob(
+        output,
+        GLYPH_SDF_WIDTH,
+        GLYPH_SDF_HEIGHT,
+        1,
+        1,
+        atlas,
+        (size_t)GLYPH_SDF_WIDTH * GLYPH_SDF_HEIGHT
+    );
+    free(atlas);
+    free(alpha);
+}
+
+int main(int argc, char** argv) {
+    if (argc == 4 && strcmp(argv[1], "atlas") == 0) {
+        bake_atlas(argv[2], argv[3]);
+        return EXIT_SUCCESS;
+    }
+    if (argc == 4 && strcmp(argv[1], "sdf") == 0) {
+        bake_sdf(argv[2], argv[3]);
+        return EXIT_SUCCESS;
+    }
+
+    fprintf(stderr, "usage: %s atlas|sdf <spritesheet.png> <output>\n", argv[0]);
+    return EXIT_FAILURE;
+}